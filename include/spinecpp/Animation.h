@@ -31,6 +31,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <spinecpp/BitSet.h>
+#include <spinecpp/Bone.h>
+
 #include <vector>
 #include <string>
 
@@ -40,6 +43,27 @@ namespace spine
 struct Event;
 class Timeline;
 class Skeleton;
+struct TimelineQuantization;
+struct KeyframeReduction;
+struct KeyframeReductionReport;
+class AnimationCache;
+class Pose;
+struct CompiledAnimationMask;
+struct SkeletonData;
+
+// The bones, slots and constraints (by index) whose values are changed by timelines
+struct AnimationTargets
+{
+    BitSet bones;
+    BitSet slots; // color, attachment and deform
+    BitSet ikConstraints;
+    BitSet transformConstraints;
+    BitSet pathConstraints;
+    bool drawOrder = false;
+
+    void clear();
+    AnimationTargets& operator|=(const AnimationTargets& other);
+};
 
 class Animation
 {
@@ -60,11 +84,96 @@ public:
       * @param alpha The amount of this animation that affects the current pose. */
     void mix(Skeleton& skeleton, float lastTime, float time, int loop, std::vector<const Event*>* outEvents, float alpha) const;
 
-    // Calls clearIdentityFrames for all timelines. See the comment in Timeline.h for more info.
+    /** Same as mix, but only the timelines in the mask are applied, each with alpha multiplied by its weight.
+      * @param mask Must be compiled for this animation. See AnimationMask.h. */
+    void mix(Skeleton& skeleton, float lastTime, float time, int loop, std::vector<const Event*>* outEvents, float alpha, const CompiledAnimationMask& mask) const;
+
+    /** Same as mix, but the deform timelines aren't applied.
+      * @param mask If not null, only the timelines in the mask are applied, like with the mix with a mask. */
+    void mixWithoutDeform(Skeleton& skeleton, float lastTime, float time, int loop, std::vector<const Event*>* outEvents, float alpha, const CompiledAnimationMask* mask) const;
+
+    /** Poses a detached pose at the specified time for this animation. No events are fired.
+      * Only the parts of the pose which the animation targets are changed. */
+    void sampleInto(Pose& pose, float time, int loop) const;
+
+    /** Same as sampleInto, but mixes the animation with the current values of the pose.
+      * @param alpha The amount of this animation that affects the current pose. */
+    void mixInto(Pose& pose, float time, int loop, float alpha) const;
+
+    /** Samples the local transforms of all bones at many times without a skeleton. The frame search of each timeline
+      * continues from the previous time, so sorted times are sampled fastest.
+      * The animation must have an up to date timeline grouping (see updateTargets).
+      * @param outPoses Receives data.bones.size() poses per time: the bones of the first time, then the bones of the
+      * second and so on. Bones which the animation doesn't change are in the setup pose. */
+    void sampleBoneTransforms(const SkeletonData& data, const float* times, size_t numTimes, int loop, BonePose* outPoses) const;
+
+    /** Same as sampleBoneTransforms, but outputs the world transforms of the bones, which are calculated with the
+      * skeleton. Constraint timelines are applied too. The bones and constraints of the skeleton are overwritten,
+      * its slots aren't changed.
+      * @param outTransforms Receives skeleton.bones.size() transforms per time. */
+    void sampleWorldTransforms(Skeleton& skeleton, const float* times, size_t numTimes, int loop, BoneWorldTransform* outTransforms) const;
+
+    // Calls clearIdentityFrames for all timelines and updates the pose end time. See the comment in Timeline.h for more info.
     void clearIdentityFramesFromTimelines();
 
+    // Replaces the rotate, translate, scale, shear and color timelines with quantized ones where possible.
+    // See QuantizedTimelines.h for more info. Updates the pose end time. Returns the number of replaced timelines.
+    int quantizeTimelines(const TimelineQuantization& settings);
+
+    // Removes the keyframes which can be reproduced by interpolating their neighbours within the
+    // error tolerances in the settings. See KeyframeReduction.h for more info.
+    // Returns the number of removed keyframes. outReport may be null.
+    size_t reduceKeyframes(const KeyframeReduction& settings, KeyframeReductionReport* outReport);
+
+    // clearIdentityFramesFromTimelines, quantizeTimelines and reduceKeyframes edit the timelines in place, so they must
+    // be called before the animation is compressed (see SkeletonData::compressAnimations).
+
+    // Recalculates targets, the pose end time and the timeline grouping used by AnimationState::applyFused from the timelines.
+    // Must be called if timelines are added or removed. SkeletonJson calls it for the animations it loads.
+    void updateTargets();
+
     float duration = 0;
+
+    // What the timelines of the animation change. See updateTargets.
+    AnimationTargets targets;
+
+    // The time from which on the animation doesn't change the pose anymore: the time of the last frame of all
+    // timelines except event timelines. See updateTargets.
+    float getPoseEndTime() const { return m_poseEndTime; }
+
+    // If the animation is in an AnimationCache, this may not contain all timelines while the animation
+    // isn't being applied. See AnimationCache.h for more info.
     std::vector<Timeline*> timelines;
+
+private:
+    friend class AnimationCache;
+    friend class AnimationState;
+    friend class AnimationMask;
+    friend class BakedAnimation;
+
+    // Wraps the times for looping animations
+    void getLoopTimes(float& lastTime, float& time, int loop) const;
+
+    // Makes sure all timelines are present until unlockTimelines is called (for animations in a cache).
+    void lockTimelines() const;
+    void unlockTimelines() const;
+
+    AnimationCache* m_cache = nullptr;
+    int m_cacheIndex = 0;
+
+    float m_poseEndTime = 0;
+
+    struct BoneTimeline
+    {
+        int boneIndex;
+        int timelineIndex;
+    };
+
+    // the timelines with a bone index, sorted by it (timelines of the same bone keep their order)
+    std::vector<BoneTimeline> m_boneTimelines;
+
+    // indices of all other timelines
+    std::vector<int> m_otherTimelines;
 };
 
 }
\ No newline at end of file
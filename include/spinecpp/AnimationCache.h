@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace spine
+{
+
+class Animation;
+class Timeline;
+struct SkeletonData;
+
+// Keeps animations in a compressed form and decompresses them into live timelines on demand.
+// The decompressed animations are kept in a least recently used list, and when their total size exceeds
+// the budget, the least recently used ones are compressed back (their timelines are destroyed).
+//
+// The compression is lossless. Frame times and values are delta coded against the previous frame
+// (by xor-ing their bits) and bit-packed.
+// Event timelines are never compressed, because the events they fire are passed around by pointer.
+// Timeline types unknown to the cache (for example quantized timelines) are not compressed either.
+// Deform timelines refer to their attachments by index in the skins of the skeleton data, so the compressed data
+// doesn't depend on addresses. Deform timelines of attachments which aren't in a skin of the data are not compressed.
+//
+// While an animation is compressed its timelines vector only contains the timelines which weren't
+// compressed. Applying the animation decompresses it.
+// The cache is not thread safe. Animations which share a cache should be applied from a single thread.
+class AnimationCache
+{
+public:
+    // The animations must belong to the data
+    AnimationCache(const SkeletonData& data);
+    ~AnimationCache();
+
+    // Compresses the animation and adds it to the cache. The animation must not be in a cache.
+    void add(Animation& animation);
+
+    // Sets the maximum total size of the decompressed animations in bytes.
+    // The most recently used animation is kept decompressed even if it alone exceeds the budget.
+    void setBudget(size_t bytes);
+    size_t getBudget() const { return m_budget; }
+
+    // Compresses all decompressed animations.
+    void evictAll();
+
+    struct Stats
+    {
+        size_t hits = 0; // animation was used while decompressed
+        size_t misses = 0; // animation had to be decompressed
+        size_t evictions = 0;
+
+        size_t residentBytes = 0; // estimated size of the decompressed timelines
+        size_t compressedBytes = 0; // size of all compressed data
+    };
+
+    const Stats& getStats() const { return m_stats; }
+    void resetCounters();
+
+private:
+    friend class Animation;
+
+    // called by the animations when they're used
+    // locked animations aren't evicted until unlocked
+    void acquire(int index, bool lock = false);
+    void unlock(int index);
+
+    void evict(int index);
+    void decompress(int index);
+    void linkFront(int index);
+    void unlink(int index);
+
+    struct Entry
+    {
+        Animation* animation;
+        std::vector<uint8_t> data;
+        std::vector<bool> compressed; // by timeline index, false for the timelines which are never evicted
+        size_t residentSize = 0;
+        bool resident = false;
+        int locks = 0;
+
+        // lru list
+        int prev = -1;
+        int next = -1;
+    };
+
+    const SkeletonData& m_data;
+
+    std::vector<Entry> m_entries;
+
+    int m_head = -1; // most recently used
+    int m_tail = -1; // least recently used
+
+    size_t m_budget = ~size_t(0);
+    Stats m_stats;
+};
+
+}
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+
+namespace spine
+{
+
+struct SkeletonData;
+class Animation;
+
+// The weights of the timelines of an animation for an AnimationMask. See AnimationMask::compile.
+struct CompiledAnimationMask
+{
+    std::vector<int> timelines; // indices of the timelines with a non-zero weight
+    std::vector<float> weights; // by timeline index (zero for the timelines which are left out)
+
+    // An empty mask means the animation isn't masked
+    bool empty() const { return weights.empty(); }
+    void clear();
+};
+
+// Per bone and per slot weights with which an animation is applied, for example to play an animation only
+// on the upper body of a skeleton. Bone timelines are weighted by the weight of their bone, and color,
+// attachment and deform timelines by the weight of their slot. The other timelines (constraints, draw
+// order and events) are not masked.
+// Since attachment timelines don't mix, their slots are either fully masked or not at all.
+class AnimationMask
+{
+public:
+    // All weights are 1
+    AnimationMask(const SkeletonData& data);
+
+    const SkeletonData& data;
+
+    std::vector<float> boneWeights;
+    std::vector<float> slotWeights;
+
+    void setAllWeights(float weight);
+
+    // Sets the weight of a bone, all bones below it in the hierarchy, and all slots of these bones
+    void setBoneTreeWeight(int boneIndex, float weight);
+
+    // Calculates the weights of the timelines of an animation. Timelines with a zero weight are left out,
+    // so they're not evaluated at all when the compiled mask is applied.
+    void compile(const Animation& animation, CompiledAnimationMask& out) const;
+};
+
+}
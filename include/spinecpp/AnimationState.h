@@ -31,13 +31,19 @@
 ////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include <spinecpp/Animation.h>
+#include <spinecpp/AnimationMask.h>
+#include <spinecpp/Pose.h>
+
 #include <vector>
 #include <functional>
+#include <memory>
 
 namespace spine
 {
 
 struct AnimationStateData;
+struct SkeletonData;
 struct Event;
 
 class AnimationState;
@@ -56,6 +62,21 @@ enum class EventType
 
 typedef std::function<void(AnimationState& state, int trackIndex, EventType type, const Event* event, int loopCount)> AnimationStateListener;
 
+// How a track entry is mixed from the previous entry of its track
+enum class MixMode
+{
+    // The previous animation is evaluated on every frame of the mix
+    Evaluate,
+
+    // The pose of the previous animation is captured when the mix starts and only the new animation is
+    // evaluated during the mix
+    Frozen,
+
+    // Like Frozen, but the bones of the captured pose keep moving with the velocity they had when the mix
+    // started, which decays to zero by the end of the mix
+    FrozenWithVelocity,
+};
+
 struct TrackEntry
 {
     TrackEntry(const AnimationState& state, const Animation& anim);
@@ -76,6 +97,22 @@ struct TrackEntry
     float mixDuration = 0;
     float mix = 1;
 
+    MixMode mixMode; // AnimationState::defaultMixMode by default
+    int/*bool*/ previousFrozen = false; // the pose of previous was captured and previous isn't evaluated anymore
+
+    // Applies the animation weighted by a mask, or removes the mask if null. The mask is compiled for the
+    // animation, so later changes to it only take effect if it's set again.
+    void setMask(const AnimationMask* mask);
+
+    // The weights of the timelines of the animation. Empty if the entry isn't masked. See setMask.
+    CompiledAnimationMask mask;
+    unsigned maskVersion = 0; // incremented by setMask, so AnimationState::isPoseUnchanged notices the change
+
+    // The mask restricted to the required bones of the skeleton the entry was last applied to (see
+    // Skeleton::setRequiredBones), and the version of the required bones for which it was compiled
+    CompiledAnimationMask requiredBonesMask;
+    unsigned requiredBonesVersion = 0;
+
     AnimationStateListener listener;
     void* rendererObject = nullptr;
 };
@@ -89,6 +126,53 @@ public:
     void update(float delta);
     void apply(Skeleton& skeleton);
 
+    // Sets to the setup pose only what the animations on the tracks target, and what was targeted by the
+    // animations applied since the last call. Can be used instead of skeleton.setToSetupPose() before apply,
+    // if the skeleton is posed only by this animation state.
+    void setTargetsToSetupPose(Skeleton& skeleton);
+
+    // Poses the skeleton like apply, but evaluates all tracks together, so the local transform of each animated
+    // bone is loaded and stored once regardless of how many track entries animate it. The resulting pose is
+    // identical to the one from apply.
+    // The listeners are called after the whole pose is applied. If they change a later track, the change takes
+    // effect on the next apply (with apply it would affect the current one).
+    // The animations must have up to date timeline groupings (see Animation::updateTargets).
+    void applyFused(Skeleton& skeleton);
+
+    // Does everything apply does except posing the skeleton: completes mixes and fires the events of the event
+    // timelines and the completions of the tracks, in the same order and with the same loop counts as apply.
+    // No other timelines are applied, so it's much cheaper. Meant for instances which aren't visible but whose
+    // events are still needed.
+    void applyEvents(Skeleton& skeleton);
+
+    // Returns true if applying the tracks now to the skeleton would result in the same pose as the last apply (or
+    // applyFused): the tracks have the same entries with the same mix and mask, none of the entries is mixing from a
+    // previous one, applyDeform and the required bones of the skeleton (see Skeleton::setRequiredBones) haven't
+    // changed, and each animation was and is at a time from which on it doesn't change the pose (see
+    // Animation::getPoseEndTime), like a finished non-looping animation, or a looping one whose frames are all at
+    // its start. Masks are only noticed when they're changed with TrackEntry::setMask.
+    // If the skeleton is in the same pose before the apply (for example the setup pose), apply and everything after
+    // it (world transforms, vertices) can be skipped. Call skipApply instead of apply to still fire the events.
+    bool isPoseUnchanged(const Skeleton& skeleton) const;
+
+    // Use instead of apply when the pose is unchanged (see isPoseUnchanged). Fires the events and completions of
+    // the tracks like apply would, without applying the other timelines.
+    void skipApply(Skeleton& skeleton);
+
+    // Returns the delta for update after which something observable happens on the tracks: an event key or a loop
+    // completion is reached, a non-looping entry completes or is cleared, or a queued entry starts. Returns 0 if that
+    // happens on the next update and apply, and infinity if nothing will ever happen (for example with a zero time
+    // scale). Mixes finishing aren't observable. Meant to be called after apply (or applyEvents), so a scheduler can
+    // put an idle instance to sleep and wake it only then. See catchUp.
+    float getTimeToNextEvent() const;
+
+    // Advances the state by delta like update followed by applyEvents, but in steps which stop at each point found
+    // by getTimeToNextEvent, so that every event, completion (with its loop count), start and end is fired like the
+    // per-frame path would fire it. A single update with a long delta would fire the events of only one loop, for
+    // example. Within one step the tracks fire in order, so events of different tracks which the per-frame path
+    // would fire in the same frame may come in time order instead. The skeleton isn't posed.
+    void catchUp(Skeleton& skeleton, float delta);
+
     void clearTracks();
     void clearTrack(int trackIndex);
 
@@ -107,6 +191,13 @@ public:
     float timeScale = 1;
     AnimationStateListener listener;
 
+    // Mix mode of new track entries
+    MixMode defaultMixMode = MixMode::Evaluate;
+
+    // If false, apply leaves out the deform timelines, so the meshes keep the deform they had. For cheaper updates of
+    // instances whose meshes don't need to be exact (see PoseLod.h). Also honored by applyFused.
+    bool applyDeform = true;
+
     std::vector<TrackEntry*> tracks;
 
     void* rendererObject = nullptr;
@@ -118,7 +209,87 @@ private:
     void disposeAllEntries(TrackEntry* entry);
     TrackEntry* expandToIndex(int index);
 
+    // Adds the events of the event timelines of the entry to m_events
+    void collectEvents(Skeleton& skeleton, const TrackEntry& current, float time);
+
+    // Calls the listeners for the events in m_events from eventsBegin to eventsEnd and for the completion of the entry
+    void dispatchEvents(int index, TrackEntry* current, float time, size_t eventsBegin, size_t eventsEnd);
+
+    // track is an index in m_fusedTracks or -1 for entries which don't fire events
+    void addFusedEntry(TrackEntry& entry, const Skeleton& skeleton, float lastTime, float time, float alpha, int track);
+
+    struct FrozenPose
+    {
+        FrozenPose(const SkeletonData& data)
+            : pose(data)
+        {}
+
+        Pose pose;
+        std::vector<BonePose> velocities; // per second, only for MixMode::FrozenWithVelocity
+        std::vector<int> boneProperties; // which local transform properties of each bone were animated
+        AnimationTargets targets; // what was captured (the masked out timelines of the previous entry aren't)
+    };
+
+    // Captures the pose of the previous entry of current
+    void freezePrevious(Skeleton& skeleton, int index, TrackEntry& current, float previousTime);
+
+    // Sets the values targeted by the previous entry of current to the captured ones
+    void applyFrozenPose(Skeleton& skeleton, int index, const TrackEntry& current);
+
+    // Sets the animated properties of a bone local transform to the captured ones
+    void applyFrozenBonePose(int index, const TrackEntry& current, int boneIndex, BonePose& inOutPose) const;
+
     std::vector<const Event*> m_events;
+
+    struct AppliedTrack
+    {
+        const TrackEntry* entry = nullptr;
+        float mix = 0;
+        float time = 0;
+        bool mixing = false;
+
+        // the other settings the pose depends on
+        unsigned maskVersion = 0;
+        unsigned requiredBonesVersion = 0;
+        bool applyDeform = true;
+    };
+
+    // the entries of the last apply
+    std::vector<AppliedTrack> m_appliedTracks;
+    void recordAppliedTrack(int index, const TrackEntry& current, float time, const Skeleton& skeleton);
+
+    AnimationTargets m_appliedTargets; // targets of the animations applied since the last setTargetsToSetupPose
+    AnimationTargets m_resetTargets;
+
+    std::vector<std::unique_ptr<FrozenPose>> m_frozenPoses; // by track
+
+    // state of applyFused
+    struct FusedEntry
+    {
+        const Animation* animation;
+        const CompiledAnimationMask* mask; // null if the entry isn't masked (see getEntryMask in AnimationState.cpp)
+        float lastTime;
+        float time;
+        float alpha;
+        int track;
+        size_t cursor; // in the bone timelines of the animation
+
+        // if not null, the captured pose of the previous entry of frozen (on track frozenIndex) is used instead of the animation
+        const TrackEntry* frozen;
+        int frozenIndex;
+    };
+    std::vector<FusedEntry> m_fusedEntries;
+
+    struct FusedTrack
+    {
+        int index;
+        TrackEntry* entry;
+        float time;
+        size_t eventsBegin = 0;
+        size_t eventsEnd = 0;
+    };
+    std::vector<FusedTrack> m_fusedTracks;
+    std::vector<TrackEntry*> m_fusedDisposedEntries;
 };
 
 }
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace spine
+{
+
+// A set of indices stored as bits. The storage grows to fit the largest index set.
+// clear() keeps the storage, so a set which is reused doesn't allocate once it has grown.
+class BitSet
+{
+public:
+    void set(size_t index)
+    {
+        size_t word = index / WORD_BITS;
+        if (word >= m_words.size())
+        {
+            m_words.resize(word + 1, 0);
+        }
+        m_words[word] |= Word(1) << (index % WORD_BITS);
+    }
+
+    bool test(size_t index) const
+    {
+        size_t word = index / WORD_BITS;
+        return word < m_words.size() && (m_words[word] & (Word(1) << (index % WORD_BITS)));
+    }
+
+    bool empty() const
+    {
+        for (auto w : m_words)
+        {
+            if (w) return false;
+        }
+        return true;
+    }
+
+    void clear()
+    {
+        for (auto& w : m_words)
+        {
+            w = 0;
+        }
+    }
+
+    BitSet& operator|=(const BitSet& other)
+    {
+        if (other.m_words.size() > m_words.size())
+        {
+            m_words.resize(other.m_words.size(), 0);
+        }
+
+        for (size_t i = 0; i < other.m_words.size(); ++i)
+        {
+            m_words[i] |= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    // Calls f(index) for each index in the set in ascending order
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (size_t i = 0; i < m_words.size(); ++i)
+        {
+            auto w = m_words[i];
+            for (size_t bit = i * WORD_BITS; w; ++bit, w >>= 1)
+            {
+                if (w & 1)
+                {
+                    f(bit);
+                }
+            }
+        }
+    }
+
+private:
+    typedef uint32_t Word;
+    static const size_t WORD_BITS = 32;
+
+    std::vector<Word> m_words;
+};
+
+}
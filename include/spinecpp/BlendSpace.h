@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <spinecpp/Animation.h>
+#include <spinecpp/Pose.h>
+#include <spinecpp/Vector.h>
+
+#include <vector>
+
+namespace spine
+{
+
+struct SkeletonData;
+class Skeleton;
+
+// Blends animations (clips) placed at positions in a one or two dimensional parameter space, for example
+// idle, walk and run by speed, or aiming by direction. The weights of the clips are calculated from the
+// parameter with gradient band interpolation and normalized. Clips whose weight is below minWeight are not
+// evaluated at all.
+// Looping clips are phase synchronized: they share a normalized time which advances with the weighted
+// average of their durations, so feet stay in step when blending walk and run cycles.
+// The clips are sampled into a pose owned by the blend space, so evaluation doesn't allocate once the
+// clips are added. No events are fired.
+class BlendSpace
+{
+public:
+    explicit BlendSpace(const SkeletonData& data);
+
+    // Adds an animation at a position in the parameter space (for one dimensional spaces y is 0).
+    // Returns the index of the clip.
+    int addClip(const Animation& animation, float x, float y = 0, bool loop = true);
+
+    // The blend parameter
+    Vector parameter = Vector(0, 0);
+
+    // Clips with a lower normalized weight are skipped and the weights of the others are renormalized
+    float minWeight = 0.01f;
+
+    float timeScale = 1;
+
+    // Calculates the clip weights for the current parameter and advances the clip times
+    void update(float delta);
+
+    // Samples the weighted clips into the pose of the blend space. The parts of the pose which no clip
+    // targets are left in the setup pose.
+    void evaluate(const Skin* skin);
+
+    // Evaluates the blend space and sets what the clips target on the skeleton. World transforms are not
+    // updated.
+    void apply(Skeleton& skeleton);
+
+    const Pose& getPose() const { return m_pose; }
+
+    // What the clips of the blend space target
+    const AnimationTargets& getTargets() const { return m_targets; }
+
+    size_t getNumClips() const { return m_clips.size(); }
+    float getClipWeight(int clip) const { return m_clips[clip].weight; }
+    float getClipTime(int clip) const { return m_clips[clip].time; }
+
+    // The normalized time of the looping clips
+    float getPhase() const { return m_phase; }
+    void setPhase(float phase);
+
+private:
+    void updateWeights();
+
+    struct Clip
+    {
+        const Animation* animation;
+        Vector position;
+        bool loop;
+        float time;
+        float weight;
+    };
+
+    std::vector<Clip> m_clips;
+    std::vector<int> m_activeClips; // clips with a non-zero weight by ascending weight
+
+    float m_phase = 0;
+
+    Pose m_pose;
+    AnimationTargets m_targets;
+};
+
+}
@@ -39,6 +39,33 @@ namespace spine
 
 class Skeleton;
 
+// The local transform of a bone
+struct BonePose
+{
+    Vector translation;
+    float rotation;
+    Vector scale;
+    Vector shear;
+};
+
+// The world transform of a bone
+struct BoneWorldTransform
+{
+    float a, b;
+    float c, d;
+    Vector worldPos;
+};
+
+// How a bone inherits the world transform of its parent
+enum class BoneInheritance
+{
+    Root, // no parent
+    Full,
+    NoScale, // inherits only the rotation
+    NoRotation, // inherits only the scale
+    None,
+};
+
 struct Bone
 {
 public:
@@ -50,9 +77,19 @@ public:
     const std::string& getName() const { return data.name; }
 
     void setToSetupPose();
+
+    BonePose getPose() const;
+    void setPose(const BonePose& pose);
     void updateWorldTransform();
     void updateWorldTransformWith(Vector translation, float rotation, Vector scale, Vector shear);
 
+    BoneInheritance getInheritance() const;
+
+    // Same as updateWorldTransform, but specialized for the inheritance, which must be the one of the bone.
+    // Instantiated for all inheritances.
+    template <BoneInheritance Inheritance>
+    void updateWorldTransformAs();
+
     float getWorldRotationX() const;
     float getWorldRotationY() const;
     float getWorldScaleX() const;
@@ -98,6 +135,9 @@ public:
     int/*bool*/ sorted;
 
 private:
+    template <BoneInheritance Inheritance>
+    void updateWorldTransformWithAs(Vector translation, float rotation, Vector scale, Vector shear);
+
     static bool m_isYDown;
 };
 
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace spine
+{
+
+struct Bone;
+
+// Structure of arrays store of the world transforms of bones, used by Skeleton::updateWorldTransform when enabled
+// (see Skeleton::setTransformStoreEnabled).
+// The bones are added in runs: bones which are updated one after another without a constraint in between. Within
+// a run the bones are grouped by depth, so the bones of a group only depend on the groups before it. The bones of a
+// group which inherit both rotation and scale from a non-root parent are updated by a kernel which processes four
+// bones per SIMD instruction, reading the world transforms of the parents from the store by their slots. The root
+// and the bones with other inheritance are updated by Bone.
+// The results are written back to the bones, so the Bone API works as usual. The local transforms (translation,
+// rotation, scale and shear) deliberately have no parallel arrays here: they stay in the bones, where the timelines
+// and constraints write them, and the kernel gathers them per bone. Moving them would need a store aware timeline
+// apply and is out of the scope of this class. The kernel calculates sines and cosines with SIMD versions of the
+// trig::sinPoly and trig::cosPoly polynomials, so the results match the ones of Bone::updateWorldTransform to float
+// precision, but not bit for bit. Without SSE2 the bones are updated by Bone.
+class BoneTransformStore
+{
+public:
+    void clear();
+
+    // Adds a run of bones in update order (parents before children). Returns the index of the run.
+    size_t addRun(const std::vector<Bone*>& bones);
+
+    // Updates the world transforms of the bones of a run
+    void updateRun(size_t run);
+
+    size_t getNumRuns() const { return m_runs.size(); }
+
+    // Updates the world transforms of bones which have a parent and inherit both rotation and scale, four at a time
+    // with the kernel, reading the world transforms of the parents from the bones. The parents must be up to date and
+    // none of the bones may be an ancestor of another one, like the same bone of different skeletons (see
+    // Skeleton::updateWorldTransforms).
+    static void updateBones(Bone* const* bones, size_t count);
+
+private:
+    // bones with the same depth in a run
+    struct Group
+    {
+        size_t begin;
+        size_t kernelEnd; // the bones from begin to kernelEnd are updated by the kernel, the rest by Bone
+        size_t end;
+    };
+
+    struct Run
+    {
+        // The parents of the bones of the run which aren't in it. Their world transforms are copied from the bones
+        // at the start of the run.
+        size_t importsBegin, importsEnd;
+
+        size_t groupsBegin, groupsEnd; // in m_groups
+    };
+
+    // copies the world transform of a slot from its bone
+    void importWorld(size_t slot);
+
+    // updates the slots from begin to end, which must be bones with a parent and the standard inheritance
+    void updateKernel(size_t begin, size_t end);
+
+    std::vector<Run> m_runs;
+    std::vector<Group> m_groups;
+
+    // the slots of all runs
+    std::vector<Bone*> m_bones;
+    std::vector<size_t> m_parents; // the slot of the parent, for the bones updated by the kernel
+
+    // world transforms
+    std::vector<float> m_a, m_b, m_c, m_d;
+    std::vector<float> m_worldX, m_worldY;
+    std::vector<float> m_signX, m_signY;
+};
+
+}
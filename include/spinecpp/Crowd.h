@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <spinecpp/Vector.h>
+#include <spinecpp/Color.h>
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace spine
+{
+
+struct SkeletonData;
+class Skeleton;
+class Skin;
+class Animation;
+class Slot;
+class RegionAttachment;
+class VertexAttachment;
+
+// An instance of a crowd, which plays an animation without mixing
+struct CrowdInstance
+{
+    const Animation* animation = nullptr;
+    float time = 0;
+    int loop = true; // kept as int for alignment purposes
+
+    // Applied on top of the shared pose when rendering the instance (see computeWorldVertices and getSlotColor)
+    Vector translation = Vector(0, 0);
+    Color color = Color(1, 1, 1, 1);
+
+    // The shared skeleton posed for the instance. Set by Crowd::update. Its world transforms don't include
+    // the translation of the instance.
+    const Skeleton* pose = nullptr;
+
+    // The world vertices of the attachment of a slot of the shared pose, with the translation of the instance instead
+    // of the one of the shared skeleton
+    void computeWorldVertices(const Slot& slot, const RegionAttachment& attachment, float* outVertices) const;
+    void computeWorldVertices(const Slot& slot, const VertexAttachment& attachment, float* outWorldVertices) const;
+
+    // The color of a slot of the shared pose for the instance: the color of the skeleton, the slot and the attachment,
+    // tinted by the color of the instance
+    Color getSlotColor(const Slot& slot, const Color& attachmentColor) const;
+};
+
+// Shares the evaluation of poses between many instances of a skeleton data which play the same animations.
+// The time of each instance is quantized to a step, and the instances with the same animation and quantized
+// time share one skeleton, which is posed and world transformed only once. Since these poses don't change,
+// they are kept between updates (up to maxPoses), so the cost of a crowd depends on the number of distinct
+// poses rather than the number of instances.
+// No events are fired for the instances.
+class Crowd
+{
+public:
+    // @param skin The skin of the shared skeletons. May be null.
+    Crowd(const SkeletonData& data, float timeStep, const Skin* skin = nullptr);
+    ~Crowd();
+
+    const SkeletonData& data;
+    const float timeStep;
+
+    // The number of shared skeletons kept between updates. Poses which weren't used for the longest time
+    // are reused first. Poses used in the current update are never reused, so more may be kept temporarily.
+    size_t maxPoses = 256;
+
+    // Sets the shared pose of each instance. Starts a new update (see beginUpdate).
+    void update(CrowdInstance* instances, size_t count);
+
+    // Starts a new update: the poses returned by getPose since the previous one may be reused from now on. Only needed
+    // when getPose is called directly instead of through update, once per frame before the calls to getPose.
+    // Otherwise the poses are never reused, and their number grows past maxPoses.
+    void beginUpdate() { ++m_update; }
+
+    // Returns the shared skeleton posed with the animation at the time quantized to the step. It stays valid until the
+    // next update (see beginUpdate).
+    // Negative times are posed at 0, and the times of a looping animation wrap around at its duration.
+    // The animation must belong to the skeleton data.
+    const Skeleton& getPose(const Animation& animation, float time, int loop);
+
+    size_t getNumPoses() const { return m_poses.size(); }
+
+    // The number of poses evaluated since the counter was reset
+    size_t getNumEvaluations() const { return m_evaluations; }
+    void resetCounters() { m_evaluations = 0; }
+
+    // Removes all poses. Must be called if the animations are changed.
+    void clear();
+
+private:
+    struct SharedPose
+    {
+        std::unique_ptr<Skeleton> skeleton;
+        uint64_t key = 0;
+        unsigned lastUpdate = 0;
+    };
+
+    // returns an unused pose for the key
+    SharedPose& allocatePose(uint64_t key);
+
+    const Skin* m_skin;
+
+    std::vector<SharedPose> m_poses;
+    std::unordered_map<uint64_t, size_t> m_poseIndices; // by key
+
+    unsigned m_update = 0;
+    size_t m_evaluations = 0;
+};
+
+}
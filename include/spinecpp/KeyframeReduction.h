@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Timeline.h"
+
+#include <cstddef>
+
+namespace spine
+{
+
+// Settings for Animation::reduceKeyframes
+//
+// Frames are removed from a timeline if linear interpolation between their neighbours reproduces them
+// (and the motion between them) within the maximum error for the timeline's type. If curve refitting is
+// enabled, spans which can't be reproduced linearly are fitted with a bezier curve instead, which allows
+// removing keys from eased motion as well.
+// Stepped frames, the first and the last frame of a timeline are always kept.
+// Only the float timelines are reduced (run it before Animation::quantizeTimelines).
+struct KeyframeReduction
+{
+    // Maximum error per timeline type. Zero or negative values disable the reduction for the type.
+    float maxRotationError = 0.05f; // degrees
+    float maxTranslationError = 0.05f; // skeleton units
+    float maxScaleError = 0.001f;
+    float maxShearError = 0.05f; // degrees
+    float maxColorError = 1.f / 255;
+    float maxMixError = 0.001f; // ik, transform and path constraint mixes
+
+    bool refitCurves = true;
+};
+
+struct KeyframeReductionReport
+{
+    struct TimelineReport
+    {
+        size_t timelineIndex; // index in Animation::timelines
+        Timeline::Type type;
+        std::vector<float> removedKeys; // times of the removed keys
+        float maxError; // in the units of the timeline's type
+    };
+
+    // only timelines which had keys removed are listed
+    std::vector<TimelineReport> timelines;
+
+    size_t removedKeys = 0;
+};
+
+// Reduces the frames of a single timeline. Returns the maximum error of the reduction.
+// If outRemovedKeys is not null the times of the removed frames are added to it.
+float reduceKeyframes(Timeline& timeline, const KeyframeReduction& settings, std::vector<float>* outRemovedKeys);
+
+}
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <spinecpp/Bone.h>
+#include <spinecpp/Color.h>
+
+#include <vector>
+#include <string>
+
+namespace spine
+{
+
+struct SkeletonData;
+class Skeleton;
+class Skin;
+class Attachment;
+struct AnimationTargets;
+
+struct SlotPose
+{
+    Color color;
+    const Attachment* attachment;
+};
+
+struct IkConstraintPose
+{
+    int bendDirection;
+    float mix;
+};
+
+struct TransformConstraintPose
+{
+    float rotateMix;
+    float translateMix;
+    float scaleMix;
+    float shearMix;
+};
+
+struct PathConstraintPose
+{
+    float position, spacing, rotateMix, translateMix;
+};
+
+// A pose of a skeleton which is detached from a Skeleton instance: the local transforms of the bones,
+// the slot colors and attachments, the draw order and the constraint mixes.
+// Animations can be sampled into poses (see Animation::sampleInto), which can then be blended and applied
+// to a skeleton. Sampling doesn't touch any Skeleton, so it can be done on a different thread than the one
+// which updates and renders the skeleton (as long as the animations aren't in an AnimationCache).
+// Deform timelines are not sampled into poses.
+class Pose
+{
+public:
+    // Creates the setup pose of the skeleton data
+    explicit Pose(const SkeletonData& data);
+
+    Pose(const Pose& other) = default;
+
+    // Copies a pose of the same skeleton data. Allocates nothing when the poses have the same data.
+    Pose& operator=(const Pose& other);
+
+    const SkeletonData& data;
+
+    // Used to find the attachments for attachment timelines. See Skeleton::setSkin.
+    const Skin* skin = nullptr;
+
+    std::vector<BonePose> bones;
+    std::vector<SlotPose> slots;
+    std::vector<int> drawOrder; // slot indices
+    std::vector<IkConstraintPose> ikConstraints;
+    std::vector<TransformConstraintPose> transformConstraints;
+    std::vector<PathConstraintPose> pathConstraints;
+
+    void setToSetupPose();
+    void resetDrawOrder();
+
+    // Copies the pose of a skeleton of the same skeleton data (including its skin).
+    void setFromSkeleton(const Skeleton& skeleton);
+
+    // Returns true if a skeleton of the same skeleton data has exactly this pose (the skin isn't compared).
+    bool matches(const Skeleton& skeleton) const;
+
+    // Sets the local transforms of the bones, the slots, the draw order and the constraint mixes of a
+    // skeleton of the same skeleton data. World transforms are not updated.
+    void applyTo(Skeleton& skeleton) const;
+
+    // Same as applyTo, but only for the targeted slots, constraints and draw order. Bones are not changed.
+    void applySlotsAndConstraintsTo(Skeleton& skeleton, const AnimationTargets& targets) const;
+
+    // Blends this pose towards another pose of the same skeleton data. The continuous values are interpolated
+    // like the timelines mix them (rotations by the shortest angle). Attachments, the draw order and bend
+    // directions are taken from the target if alpha is at least 0.5.
+    void blend(const Pose& target, float alpha);
+
+    // Returns 0 if the attachment was not found. Same as Skeleton::getAttachmentForSlotIndex.
+    const Attachment* getAttachmentForSlotIndex(int slotIndex, const std::string& attachmentName) const;
+};
+
+}
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <spinecpp/Pose.h>
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+
+namespace spine
+{
+
+class Animation;
+class Skeleton;
+struct SkeletonData;
+struct Event;
+
+enum class BakedSampling
+{
+    Nearest, // the closest sample is used
+    Linear, // the two closest samples are interpolated (discrete values come from the earlier one)
+};
+
+// An animation sampled at a fixed rate into a table of poses, which can be played back by lookup instead
+// of evaluating its timelines. Only what the animation targets is stored: the local transforms of the
+// animated bones, the colors and attachments of the animated slots, the draw order and the constraint mixes.
+// The samples are taken as if the animation was applied on the setup pose, so baked playback is meant for
+// skeletons which play the animation on its own (without mixing).
+// Deform and event timelines are not baked, they are evaluated when the animation is played back.
+class BakedAnimation
+{
+public:
+    const Animation& animation;
+    const float fps;
+
+    // Poses the skeleton with the baked samples at the specified time.
+    // @param lastTime The last time the animation was applied (for events).
+    // @param events Any triggered events are added. May be null.
+    void apply(Skeleton& skeleton, float lastTime, float time, int loop, std::vector<const Event*>* outEvents, BakedSampling sampling) const;
+
+    int getNumSamples() const { return m_numSamples; }
+
+    // The size of the baked samples in bytes
+    size_t getSize() const;
+
+private:
+    friend class PoseCache;
+
+    BakedAnimation(const Animation& animation, float fps);
+
+    void bake(const SkeletonData& data);
+
+    float getSampleTime(int sample) const;
+
+    int m_numSamples = 0;
+
+    // what is baked (indices in the skeleton)
+    std::vector<int> m_bones;
+    std::vector<int> m_colorSlots;
+    std::vector<int> m_attachmentSlots;
+    bool m_drawOrder = false;
+    std::vector<int> m_ikConstraints;
+    std::vector<int> m_transformConstraints;
+    std::vector<int> m_pathConstraints;
+
+    // indices of the timelines evaluated on playback
+    std::vector<int> m_liveTimelines;
+
+    // The samples. Each vector stores all values of a sample one after another.
+    std::vector<BonePose> m_bonePoses;
+    std::vector<Color> m_colors;
+    std::vector<int> m_attachments; // index in m_attachmentNames, -1 for no attachment, -2 if the slot isn't changed yet
+    std::vector<std::string> m_attachmentNames;
+    std::vector<int> m_drawOrders;
+    std::vector<IkConstraintPose> m_ikPoses;
+    std::vector<TransformConstraintPose> m_transformPoses;
+    std::vector<PathConstraintPose> m_pathPoses;
+};
+
+// Baked animations of a skeleton data. Baking is opt-in per animation and limited by a memory budget.
+class PoseCache
+{
+public:
+    PoseCache(const SkeletonData& data);
+    ~PoseCache();
+
+    // Bakes an animation at the specified number of samples per second. If it's already baked at a different
+    // rate it's baked again. Returns nullptr (and the animation isn't baked) if the baked animation doesn't
+    // fit in the budget.
+    const BakedAnimation* bake(const Animation& animation, float fps);
+
+    // Returns nullptr if the animation isn't baked
+    const BakedAnimation* find(const Animation& animation) const;
+
+    void remove(const Animation& animation);
+    void clear();
+
+    // Sets the maximum total size of the baked animations in bytes. Already baked animations are kept.
+    void setBudget(size_t bytes) { m_budget = bytes; }
+    size_t getBudget() const { return m_budget; }
+
+    // The total size of the baked animations in bytes
+    size_t getSize() const { return m_size; }
+
+private:
+    const SkeletonData& m_data;
+
+    std::vector<std::unique_ptr<BakedAnimation>> m_animations;
+
+    size_t m_size = 0;
+    size_t m_budget = ~size_t(0);
+};
+
+}
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cstddef>
+
+namespace spine
+{
+
+class Skeleton;
+class AnimationState;
+
+// How an instance is updated by a PoseLodScheduler
+struct PoseLod
+{
+    PoseLod() {}
+    PoseLod(int rate, bool constraints, bool deform)
+        : rate(rate)
+        , constraints(constraints)
+        , deform(deform)
+    {}
+
+    // The instance is posed (its animation state applied and world transforms updated) on one of each rate frames:
+    // 1, 2, 4 or 8. The animation state is still updated and its events fired on every frame.
+    int rate = 1;
+
+    bool constraints = true; // apply the IK, transform and path constraints
+    bool deform = true; // apply the deform timelines
+};
+
+// Chooses a PoseLod from the distance of an instance (in any unit, for example from the camera or inversely to its
+// size on screen) and whether it's visible
+struct PoseLodPolicy
+{
+    // the distances from which on the rate is halved, quartered and divided by eight
+    float halfRateDistance = 1e30f;
+    float quarterRateDistance = 1e30f;
+    float eighthRateDistance = 1e30f;
+
+    // the distances from which on the constraints and deform timelines are left out
+    float noConstraintsDistance = 1e30f;
+    float noDeformDistance = 1e30f;
+
+    // the LOD of instances which aren't visible
+    PoseLod invisible = PoseLod(8, false, false);
+
+    PoseLod getLod(float distance, bool visible) const;
+};
+
+struct PoseLodInstance
+{
+    Skeleton* skeleton = nullptr;
+    AnimationState* state = nullptr;
+
+    PoseLod lod;
+
+    // The frame (modulo the rate) on which the instance is posed. Assigned by the scheduler when the instance is first
+    // updated (it's posed on that frame) and whenever its rate changes.
+    int phase = -1;
+    int phaseRate = 0; // the rate for which the phase was assigned
+
+    // Set by PoseLodScheduler::update: true if the instance was posed on the last frame. Otherwise its skeleton has the
+    // pose and world transforms of the last frame on which it was posed.
+    bool posed = false;
+};
+
+// Updates many instances with reduced rates and features depending on their LOD. On every frame, the animation state
+// and skeleton of each instance are updated by the frame delta, so their times are the same as at full rate. Instances
+// are posed only on the frames of their rate. On the other frames AnimationState::applyEvents fires the events and
+// completions on time, without posing the skeleton. The phases of the instances are spread over the frames (each
+// instance which gets a rate gets the next phase for that rate), so about the same number of instances with each rate
+// is posed on each frame and the cost per frame stays flat.
+class PoseLodScheduler
+{
+public:
+    // Updates and, if it's their turn, poses the instances. The skeletons aren't reset to the setup pose before the
+    // animation states are applied, unless resetTargets is set.
+    void update(PoseLodInstance* instances, size_t count, float delta);
+
+    // Calls AnimationState::setTargetsToSetupPose before the instances are posed
+    bool resetTargets = false;
+
+    unsigned getFrame() const { return m_frame; }
+
+private:
+    unsigned m_frame = 0;
+    unsigned m_nextPhases[4] = {}; // by rate 1, 2, 4 and 8
+};
+
+}
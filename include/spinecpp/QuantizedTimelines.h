@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Timeline.h"
+#include "Vector.h"
+#include "Color.h"
+
+#include <cstdint>
+
+namespace spine
+{
+
+struct CurveFrame;
+
+// Settings for Animation::quantizeTimelines
+//
+// Quantized timelines store frame times as uint16 frame indices at a fixed rate, rotation, translation,
+// scale and shear values as uint16 fractions of the timeline's own value range, and colors as RGBA8.
+// A timeline is only quantized if all of its keys lie on distinct frames of the grid and the value quantization
+// error is within the specified maximum for its type. Otherwise it's left as it is.
+struct TimelineQuantization
+{
+    // The rate at which the animations were exported.
+    float fps = 30;
+
+    // Maximum distance (in seconds) of a key from the frame grid for it to be considered on it.
+    float maxTimeError = 0.0005f;
+
+    // Maximum quantization error per timeline type. Zero or negative values disable quantization for the type.
+    float maxRotationError = 0.01f; // degrees
+    float maxTranslationError = 0.01f; // skeleton units
+    float maxScaleError = 0.0001f;
+    float maxShearError = 0.01f; // degrees
+
+    bool quantizeColors = true; // colors have a fixed error of 1/510
+};
+
+class QuantizedCurveTimeline : public Timeline
+{
+public:
+    float getFps() const { return m_fps; }
+
+    // Returns the value to be stored in a frame's curve member for the curve of the source frame
+    uint16_t addCurve(const CurveFrame& source);
+
+    // Special values of Frame::curve. Values >= Curve_Bezier are indices of bezier curves (+Curve_Bezier).
+    enum : uint16_t
+    {
+        Curve_Linear = 0,
+        Curve_Stepped = 1,
+        Curve_Bezier = 2,
+    };
+
+protected:
+    QuantizedCurveTimeline(Timeline::Type type, float fps);
+
+    float getCurvePercent(uint16_t curve, float percent) const;
+
+    const float m_fps;
+
+    // bezier data for bezier frames only
+    // identical curves are stored once
+    std::vector<Vector> m_bezierData;
+};
+
+// Stores the values of a timeline as uint16 fractions of the range [min, min + 65535*step]
+struct QuantizationRange
+{
+    float min = 0;
+    float step = 0;
+
+    float get(uint16_t q) const { return min + float(q) * step; }
+};
+
+class QuantizedRotateTimeline : public QuantizedCurveTimeline
+{
+public:
+    QuantizedRotateTimeline(int framesCount, float fps);
+
+    virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual int getBoneIndex() const override;
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const override;
+
+    virtual void clearIdentityFrames() override;
+
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
+    struct Frame
+    {
+        uint16_t time; // frame index at fps
+        uint16_t curve;
+        uint16_t angle;
+    };
+
+    std::vector<Frame> frames;
+    QuantizationRange angleRange;
+    int boneIndex = 0;
+
+private:
+    void applyToValue(const BoneData& data, float time, float alpha, float& inOutRotation, size_t* frameHint) const;
+};
+
+// Base class for the quantized translate, scale and shear timelines
+class QuantizedVectorTimeline : public QuantizedCurveTimeline
+{
+public:
+    virtual int getBoneIndex() const override;
+
+    virtual void clearIdentityFrames() override;
+
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
+    struct Frame
+    {
+        uint16_t time; // frame index at fps
+        uint16_t curve;
+        uint16_t x, y;
+    };
+
+    std::vector<Frame> frames;
+    QuantizationRange xRange, yRange;
+    int boneIndex = 0;
+
+protected:
+    QuantizedVectorTimeline(int framesCount, float fps, Timeline::Type type);
+
+    // Returns false if the time is before the first frame
+    bool getValue(float time, Vector& outValue, size_t* frameHint) const;
+};
+
+class QuantizedTranslateTimeline : public QuantizedVectorTimeline
+{
+public:
+    QuantizedTranslateTimeline(int framesCount, float fps);
+
+    virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const override;
+
+private:
+    void applyToValue(const BoneData& data, float time, float alpha, Vector& inOutValue, size_t* frameHint) const;
+};
+
+class QuantizedScaleTimeline : public QuantizedVectorTimeline
+{
+public:
+    QuantizedScaleTimeline(int framesCount, float fps);
+
+    virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const override;
+
+private:
+    void applyToValue(const BoneData& data, float time, float alpha, Vector& inOutValue, size_t* frameHint) const;
+};
+
+class QuantizedShearTimeline : public QuantizedVectorTimeline
+{
+public:
+    QuantizedShearTimeline(int framesCount, float fps);
+
+    virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const override;
+
+private:
+    void applyToValue(const BoneData& data, float time, float alpha, Vector& inOutValue, size_t* frameHint) const;
+};
+
+class QuantizedColorTimeline : public QuantizedCurveTimeline
+{
+public:
+    QuantizedColorTimeline(int framesCount, float fps);
+
+    virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual void clearIdentityFrames() override;
+
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
+    struct Frame
+    {
+        uint16_t time; // frame index at fps
+        uint16_t curve;
+        uint8_t r, g, b, a;
+    };
+
+    std::vector<Frame> frames;
+    int slotIndex = 0;
+
+private:
+    void applyToValue(float time, float alpha, Color& inOutColor) const;
+};
+
+// Returns a new quantized copy of the timeline or nullptr if the timeline can't be quantized with the
+// given settings. The source timeline is not modified.
+Timeline* quantizeTimeline(const Timeline& timeline, const TimelineQuantization& settings);
+
+}
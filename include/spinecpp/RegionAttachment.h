@@ -39,6 +39,7 @@ namespace spine
 {
 
 struct Bone;
+struct BoneWorldTransform;
 
 class RegionAttachment : public Attachment
 {
@@ -52,6 +53,14 @@ public:
 
     void computeWorldVertices(const Bone& bone, float* outVertices) const;
 
+    // Same as the above, but with the world transform of the bone taken from transforms (by bone index), for example
+    // the interpolated ones from Skeleton::interpolateWorldTransforms
+    void computeWorldVertices(const Bone& bone, const BoneWorldTransform* transforms, float* outVertices) const;
+
+    // Same as the first one, but with the given translation instead of the one of the skeleton, for example the one of
+    // a crowd instance which shares the skeleton (see CrowdInstance::computeWorldVertices)
+    void computeWorldVertices(const Bone& bone, const Vector& translation, float* outVertices) const;
+
     const std::string path;
     Vector translation = Vector(0, 0);
     Vector scale = Vector(1, 1);
@@ -37,10 +37,21 @@
 #include "IkConstraint.h"
 #include "TransformConstraint.h"
 #include "PathConstraint.h"
+#include "Pose.h"
+#include "BitSet.h"
+#include "BoneTransformStore.h"
+#include "AnimationMask.h"
+
+#include <memory>
+#include <functional>
 
 namespace spine
 {
 
+// Runs count tasks, calling task(i) for each i from 0 to count - 1, possibly in parallel, and returns when all are done.
+// See Skeleton::updateWorldTransform.
+typedef std::function<void(size_t count, const std::function<void(size_t)>& task)> TaskExecutor;
+
 class Skeleton
 {
 public:
@@ -51,12 +62,105 @@ public:
     void updateCache();
     void updateWorldTransform();
 
+    /* Updates the world transforms, unless the pose of the skeleton (the local transforms of the bones, the slots, the
+    * draw order, the constraint mixes and the translation and flip of the skeleton) is the same as at the last call.
+    * Returns false if the pose was unchanged, in which case the world transforms and anything generated from them (like
+    * vertices) are still valid. Deform vertices aren't compared. The first call always updates, and so does the first
+    * call after the world transforms were changed by another update (or after updateCache, for example from
+    * setRequiredBones). */
+    bool updateWorldTransformIfChanged();
+
+    /* Recomputes only the world transforms which depend on something that changed since the last call: the bones whose
+    * local transforms changed and their descendants, and the constraints whose mixes changed or which use recomputed
+    * bones, followed by the bones they affect. Changes are found by comparing with the pose at the last call, so the
+    * skeleton can be posed in any way (animations, setters, gameplay code). The world transforms are the same as the ones
+    * from updateWorldTransform, which is called instead on the first call, after updateCache or updateWorldTransform,
+    * and when the skeleton is flipped. World transforms must not be changed by anything else between the calls.
+    * Path constraints whose target slot has deform vertices are always applied (deform isn't compared). The transform
+    * store isn't used. Returns false if nothing was recomputed. */
+    bool updateWorldTransformIncrementally();
+
+    /* Same as updateWorldTransform, but the bones and constraints which don't depend on each other are updated in
+    * parallel by the executor. The update order is split into levels (see getNumUpdateLevels): the elements of a level
+    * only use world transforms changed by earlier levels, so a bone waits only for its ancestors and the constraints
+    * before it, and independent branches are updated at the same time. The executor is called once per level with
+    * enough elements, with one task per elementsPerTask elements. Smaller levels are updated on the calling thread.
+    * The world transforms are the same as the ones from updateWorldTransform. The transform store isn't used.
+    * Pays off for skeletons with many bones in wide branches, if the executor starts tasks quickly (for example a pool
+    * of threads waiting for work), since it's called for each level. */
+    void updateWorldTransform(const TaskExecutor& executor, size_t elementsPerTask = 32);
+
+    // The number of levels of updateWorldTransform with an executor, which is the longest chain of elements of the
+    // update order which depend on each other
+    size_t getNumUpdateLevels();
+
+    // The indices of the bones in the order in which updateWorldTransform first changes their world transforms,
+    // including the bones changed only by constraints. Parents come before their children. The bones which aren't
+    // updated are at the end. See SkeletonJson::setReorderBones.
+    std::vector<int> getBoneUpdateOrder() const;
+
+    /* Updates the world transforms of many skeletons of the same skeleton data in lockstep: each bone or constraint of
+    * the update order is done for all skeletons before the next one, so the walk of the update cache and the inheritance
+    * decisions are shared, and the bones which inherit rotation and scale are updated four skeletons at a time with
+    * SIMD instructions (see BoneTransformStore::updateBones). The world transforms match the ones of
+    * updateWorldTransform to float precision, but not bit for bit. Skeletons whose update order differs from the one of
+    * the first skeleton (for example because of a skin with different path attachments) are updated separately. */
+    static void updateWorldTransforms(Skeleton* const* skeletons, size_t count);
+
+    /* Restricts the work of updateWorldTransform (and of AnimationState::apply) to what's needed for the world
+    * transforms of the given bones (by index): the bones they depend on (ancestors, constraint targets, the bones of
+    * path attachments), the constraints which change any of these bones, and the timelines of these bones and of the
+    * target slots of these path constraints. Constraint, draw order and event timelines are always applied. The world
+    * transforms of the other bones aren't updated, so they're stale, and so is anything computed from them (like the
+    * vertices of attachments on them). Meant for headless use, for example on a server which only needs hitboxes.
+    * An empty list restores the full update. AnimationState::applyFused is restricted like apply,
+    * updateWorldTransformWithoutConstraints isn't. */
+    void setRequiredBones(const std::vector<int>& boneIndices);
+    const std::vector<int>& getRequiredBones() const { return m_requiredBones; }
+
+    // The weights of the timelines needed for the required bones (see setRequiredBones): one for the needed bones and
+    // slots, zero for the others. Null if all bones are required.
+    const AnimationMask* getRequiredBonesMask() const { return m_requiredBonesMask.get(); }
+
+    // Changes whenever the required bones mask is recalculated (by setRequiredBones or updateCache). Unique among all
+    // skeletons, so it can be used to tell if something compiled from the mask is up to date.
+    unsigned getRequiredBonesVersion() const { return m_requiredBonesVersion; }
+
+    /* Updates the world transforms of the bones from their local transforms in bone order, without applying the IK,
+    * transform and path constraints. For cheaper updates of instances for which the constraints aren't needed (see
+    * PoseLod.h). */
+    void updateWorldTransformWithoutConstraints();
+
+    /* Makes updateWorldTransform go through a BoneTransformStore, which updates the bones that inherit rotation and scale
+    * four at a time with SIMD instructions. The world transforms are the same to float precision, but not bit for bit
+    * (see BoneTransformStore.h). Pays off for skeletons with many bones at the same depth. Disabled by default. */
+    void setTransformStoreEnabled(bool enabled);
+    bool isTransformStoreEnabled() const { return !!m_transformStore; }
+
+    /* For rendering at a higher rate than the skeleton is updated: call after updateWorldTransform on each update (tick)
+    * to keep the world transforms of the tick. The ones of the previous tick are kept too. The first call after
+    * construction or updateCache stores the same transforms for both ticks. */
+    void storeTickWorldTransforms();
+
+    /* Outputs the world transforms of the bones (by index) between the previous tick (alpha 0) and the last tick
+    * (alpha 1), see storeTickWorldTransforms. The axes of each transform are rotated along the shorter arc and their
+    * lengths are interpolated separately, so a rotating bone keeps its scale (and shear) instead of shrinking like with
+    * a linear interpolation of a, b, c and d. The world positions are interpolated linearly. The skeleton translation
+    * isn't part of the world transforms. The vertices of attachments can be computed from the output directly (see
+    * VertexAttachment::computeWorldVertices and RegionAttachment::computeWorldVertices), without changing the bones.
+    * @param outTransforms Receives bones.size() transforms. */
+    void interpolateWorldTransforms(float alpha, BoneWorldTransform* outTransforms) const;
+
     /* Sets the bones, constraints, and slots to their setup pose values. */
     void setToSetupPose();
     /* Sets the bones and constraints to their setup pose values. */
     void setBonesToSetupPose();
     void setSlotsToSetupPose();
 
+    /* Sets only the bones, constraints and slots in targets (and the draw order if it's targeted) to their setup pose values.
+    * Everything else is left unchanged. */
+    void setToSetupPose(const AnimationTargets& targets);
+
     // sets draw order to identity
     void resetDrawOrder();
 
@@ -86,7 +190,7 @@ public:
     * @param skinName May be empty. */
     bool setSkinByName(const std::string& name);
 
-    const Skin* getSkin() { return m_skin; }
+    const Skin* getSkin() const { return m_skin; }
 
     /* Returns 0 if the slot or attachment was not found. */
     const Attachment* getAttachmentForSlotName(const std::string& slotName, const std::string& attachmentName) const;
@@ -130,9 +234,32 @@ public:
 private:
     const Skin* m_skin = nullptr;
 
+    // the pose at the last updateWorldTransformIfChanged
+    std::unique_ptr<Pose> m_updatedPose;
+    Vector m_updatedTranslation;
+    bool m_updatedFlipX = false, m_updatedFlipY = false;
+    bool m_updatedPoseValid = false; // false if the world transforms may not match m_updatedPose
+
+    // state of updateWorldTransformIncrementally
+    std::unique_ptr<Pose> m_incrementalPose; // the pose at the last call
+    Vector m_incrementalTranslation;
+    bool m_incrementalFlipX = false, m_incrementalFlipY = false;
+    bool m_incrementalPoseValid = false; // false if the world transforms may not match m_incrementalPose
+    BitSet m_changedBones; // bones which must be recomputed (by index)
+    BitSet m_changedConstraints; // constraints which must be applied (by position in m_updateOrder)
+    BitSet m_dirtyBones; // bones recomputed so far in the current incremental update
+    BitSet m_dirtyUpdates; // positions in m_updateOrder to update
+
+    // Finds m_dirtyUpdates from m_changedBones and m_changedConstraints
+    void findDirtyUpdates();
+
+    // if not null, the runs of bones in the update cache are updated through it
+    std::unique_ptr<BoneTransformStore> m_transformStore;
+
     enum class UpdateCacheType
     {
         Bone,
+        BoneRun, // a run of bones in m_transformStore
         IkConstraint,
         PathConstraint,
         TransformConstraint,
@@ -143,6 +270,9 @@ private:
     void sortPathConstraintAttachment(const Skin& skin, int slotIndex, Bone& slotBone);
     void sortPathConstraintAttachmentBones(const Attachment* attachment, Bone& slotBone);
 
+    // replaces the runs of bones in the update cache with runs in m_transformStore
+    void addTransformStoreRuns();
+
     struct UpdateCacheElem
     {
         UpdateCacheElem(Bone& b)
@@ -165,10 +295,74 @@ private:
             , type(UpdateCacheType::TransformConstraint)
         {}
 
+        explicit UpdateCacheElem(size_t boneRun)
+            : data(nullptr)
+            , type(UpdateCacheType::BoneRun)
+            , run(boneRun)
+        {}
+
         void* data;
         UpdateCacheType type;
+        size_t run = 0; // for BoneRun
     };
     std::vector<UpdateCacheElem> m_updateCache;
+
+    // the update cache without transform store runs, for updateWorldTransformIncrementally and updateWorldTransforms
+    std::vector<UpdateCacheElem> m_updateOrder;
+
+    // the position of the last element in m_updateOrder which changes the world transform of each bone (by index)
+    std::vector<size_t> m_lastBoneUpdates;
+
+    // m_updateOrder sorted by level for updateWorldTransform with an executor. Built when first needed.
+    struct UpdateLevel
+    {
+        size_t begin, end; // in m_levelOrder
+    };
+    std::vector<UpdateLevel> m_updateLevels;
+    std::vector<size_t> m_levelOrder; // positions in m_updateOrder
+
+    void buildUpdateLevels();
+
+    // adds the bones whose world transforms the element uses and changes
+    void getElemBones(const UpdateCacheElem& c, std::vector<const Bone*>& used, std::vector<const Bone*>& changed) const;
+
+    // removes the elements of the update cache which aren't needed for the required bones, and sets the mask
+    void removeUnrequiredUpdates();
+
+    std::vector<int> m_requiredBones;
+    std::unique_ptr<AnimationMask> m_requiredBonesMask;
+    unsigned m_requiredBonesVersion = 0;
+
+    // updates the element of m_updateOrder at the position
+    void updateOrderElem(size_t position);
+
+    // returns true if the other skeleton has the same update order (with its own bones and constraints)
+    bool hasSameUpdateOrder(const Skeleton& other) const;
+
+    // The update cache compiled into runs of the same work (like bones with the same inheritance or constraints of the
+    // same type), each done by a function specialized for it at compile time. See compileUpdateSteps.
+    struct UpdateStep
+    {
+        void (*update)(Skeleton& skeleton, const UpdateStep& step);
+        size_t begin; // in m_updateItems, or the run in m_transformStore
+        size_t count;
+    };
+    std::vector<UpdateStep> m_updateSteps;
+    std::vector<void*> m_updateItems; // the bones and constraints of the steps
+
+    void compileUpdateSteps();
+
+    template <BoneInheritance Inheritance>
+    static void updateBones(Skeleton& skeleton, const UpdateStep& step);
+
+    template <typename Constraint>
+    static void applyConstraints(Skeleton& skeleton, const UpdateStep& step);
+
+    static void updateTransformStoreRun(Skeleton& skeleton, const UpdateStep& step);
+
+    // the world transforms of the last two ticks, see storeTickWorldTransforms
+    std::vector<BoneWorldTransform> m_previousTickTransforms;
+    std::vector<BoneWorldTransform> m_tickTransforms;
 };
 
 }
@@ -36,6 +36,8 @@
 #include <spinecpp/Skin.h>
 #include <spinecpp/EventData.h>
 #include <spinecpp/Animation.h>
+#include <spinecpp/AnimationCache.h>
+#include <spinecpp/PoseCache.h>
 #include <spinecpp/IkConstraintData.h>
 #include <spinecpp/TransformConstraintData.h>
 #include <spinecpp/PathConstraintData.h>
@@ -51,6 +53,11 @@ struct SkeletonData
     Vector size = Vector(0, 0);
 
     std::vector<BoneData> bones;
+
+    // If the bones were reordered when loading (see SkeletonJson::setReorderBones), the index of each bone by its
+    // index in the exported data. Empty otherwise.
+    std::vector<int> boneIndicesByExportedIndex;
+
     std::vector<SlotData> slots;
     std::vector<Skin> skins;
     Skin* defaultSkin = nullptr;
@@ -60,6 +67,19 @@ struct SkeletonData
     std::vector<TransformConstraintData> transformConstraints;
     std::vector<PathConstraintData> pathConstraints;
 
+    // Holds the compressed animations. Declared after the animations, so it's destroyed before them.
+    AnimationCache animationCache{ *this };
+
+    // Compresses all animations into the animation cache and sets its budget (in bytes) for decompressed animations.
+    // Must be called after the animations are loaded, since the cache refers to their addresses, and after their
+    // timelines are edited (Animation::clearIdentityFramesFromTimelines, quantizeTimelines and reduceKeyframes), which
+    // isn't allowed once they're compressed.
+    void compressAnimations(size_t residentBudget);
+
+    // Animations baked into pose tables for playback by lookup. Nothing is baked unless requested.
+    // See PoseCache.h for more info.
+    PoseCache poseCache{ *this };
+
     const BoneData* findBone(const char* boneName) const;
     int findBoneIndex(const char* boneName) const;
 
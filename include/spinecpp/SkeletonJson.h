@@ -64,7 +64,19 @@ public:
 
     void setScale(float s) { m_scale = s; }
 
+    // If enabled, the bones of the loaded skeleton data are ordered like they're first updated by
+    // Skeleton::updateWorldTransform (constraints included), instead of in the exported order. Parents still come
+    // before their children. Updating world transforms and vertices then goes through the bones of a skeleton mostly
+    // in memory order. All bone indices in the data (of timelines, weighted vertices, slots and constraints) use the new
+    // order. Indices from outside (for example from an exported list of bones) can be converted with
+    // SkeletonData::boneIndicesByExportedIndex. Disabled by default. Loading takes a bit longer, since the bones, slots
+    // and constraints are read twice (the attachments are loaded once). The order is found without the skins, so the
+    // bones of weighted path attachments are placed only by their hierarchy and the constraints on them.
+    void setReorderBones(bool reorder) { m_reorderBones = reorder; }
+
 private:
+    SkeletonData* readSkeleton(const sajson::value& root, bool bonesAndConstraintsOnly);
+
     void setError(const std::string& e1, const std::string& e2);
 
     void readAnimation(Animation& outAnim, const SkeletonData& skeletonData, const sajson::value& json);
@@ -87,6 +99,12 @@ private:
     };
 
     float m_scale = 1.f;
+    bool m_reorderBones = false;
+
+    // when reordering the bones, the exported index of each bone, and the index of each bone by its exported index
+    std::vector<int> m_boneOrder;
+    std::vector<int> m_boneIndices;
+
     bool m_ownsLoader;
     AttachmentLoader* m_loader;
     std::string m_error;
@@ -58,6 +58,12 @@ public:
     // Returns nullptr if the slot or attachment was not found.
     const char* getAttachmentName(int slotIndex, int attachmentIndex) const;
 
+    // The index of the attachment among all attachments of the skin, or -1 if it's not in the skin
+    int getEntryIndex(const Attachment* attachment) const;
+
+    // Returns nullptr if the index is out of range. See getEntryIndex.
+    const Attachment* getEntryAttachment(int entryIndex) const;
+
     // Attach each attachment in this skin if the corresponding attachment in oldSkin is currently attached.
     void attachAll(Skeleton& skeleton, const Skin& oldSkin) const;
 
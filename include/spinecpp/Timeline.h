@@ -32,12 +32,17 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 
 namespace spine
 {
 
 struct Event;
 class Skeleton;
+struct AnimationTargets;
+struct BonePose;
+struct BoneData;
+class Pose;
 
 class Timeline
 {
@@ -58,6 +63,11 @@ public:
         PathConstraintPosition,
         PathConstraintSpacing,
         PathConstraintMix,
+        QuantizedRotate,
+        QuantizedTranslate,
+        QuantizedScale,
+        QuantizedShear,
+        QuantizedColor,
     };
 
     Timeline(Type type)
@@ -66,14 +76,34 @@ public:
 
     virtual ~Timeline() {}
 
+    Type getType() const { return type; }
+
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const = 0;
 
+    // Does the same as apply, but to a pose instead of a skeleton. Events are not fired.
+    virtual void applyToPose(Pose& pose, float time, float alpha) const = 0;
+
+    // Timelines which only change the local transform of a single bone return its index. Others return -1.
+    virtual int getBoneIndex() const { return -1; }
+
+    // For timelines with a bone index. Does the same as apply, but to the given local transform instead of the bone.
+    // data is the data of the bone.
+    // frameHint may be null. Otherwise the frame search starts at it and it's updated with the found frame, so
+    // calls with increasing times and the same hint don't search the frames from the start.
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const {}
+
     // Will clear all frames except the first if the transformations inside are identical.
     // This may be unsafe if your code relies on changing individual frames of individual timelines.
     // This however is probably rarely the case. If it is not, you can safely call this function to 
     // get rid of frames left by mistake by the animators.
     virtual void clearIdentityFrames() = 0;
 
+    // Adds the bones, slots or constraints changed by the timeline to targets.
+    virtual void addTargets(AnimationTargets& targets) const = 0;
+
+    // The time of the last frame. From then on the timeline doesn't change anything.
+    virtual float getLastFrameTime() const = 0;
+
 private:
     const Type type;
 };
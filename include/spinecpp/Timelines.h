@@ -55,6 +55,10 @@ struct CurveFrame
 
     float getCurvePercent(float percent) const;
 
+    // Evaluates a bezier curve given its precomputed BEZIER_DATA_SIZE points (as set by setCurve).
+    // percent must be in [0, 1]
+    static float getBezierCurvePercent(const Vector* bezierData, float percent);
+
     bool isSameCurveAs(const CurveFrame& other) const;
 
     enum class Type
@@ -87,9 +91,17 @@ public:
     RotateTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual int getBoneIndex() const override;
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -98,6 +110,9 @@ public:
 
     std::vector<Frame> frames;
     int boneIndex = 0;
+
+private:
+    void applyToValue(const BoneData& data, float time, float alpha, float& inOutRotation, size_t* frameHint) const;
 };
 
 class TranslateTimeline : public CurveTimeline
@@ -106,9 +121,17 @@ public:
     TranslateTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual int getBoneIndex() const override;
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -117,6 +140,9 @@ public:
 
     std::vector<Frame> frames;
     int boneIndex = 0;
+
+private:
+    void applyToValue(const BoneData& data, float time, float alpha, Vector& inOutTranslation, size_t* frameHint) const;
 };
 
 class ScaleTimeline : public CurveTimeline
@@ -125,9 +151,17 @@ public:
     ScaleTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual int getBoneIndex() const override;
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -136,6 +170,9 @@ public:
 
     std::vector<Frame> frames;
     int boneIndex = 0;
+
+private:
+    void applyToValue(const BoneData& data, float time, float alpha, Vector& inOutScale, size_t* frameHint) const;
 };
 
 class ShearTimeline : public CurveTimeline
@@ -144,9 +181,17 @@ public:
     ShearTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
+
+    virtual int getBoneIndex() const override;
+    virtual void applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -155,6 +200,9 @@ public:
 
     std::vector<Frame> frames;
     int boneIndex = 0;
+
+private:
+    void applyToValue(const BoneData& data, float time, float alpha, Vector& inOutShear, size_t* frameHint) const;
 };
 
 class ColorTimeline : public CurveTimeline
@@ -163,9 +211,14 @@ public:
     ColorTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -174,6 +227,9 @@ public:
 
     std::vector<Frame> frames;
     int slotIndex = 0;
+
+private:
+    void applyToValue(float time, float alpha, Color& inOutColor) const;
 };
 
 class AttachmentTimeline : public Timeline
@@ -182,9 +238,14 @@ public:
     AttachmentTimeline();
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame
     {
         // @param attachmentName May be empty.
@@ -198,6 +259,10 @@ public:
 
     std::vector<Frame> frames;
     int slotIndex = 0;
+
+private:
+    // Returns the frame for the time or nullptr if the time is before the first frame
+    const Frame* getFrame(float time) const;
 };
 
 class EventTimeline : public Timeline
@@ -206,9 +271,14 @@ public:
     EventTimeline();
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     typedef Event Frame;
     std::vector<Frame> frames;
 };
@@ -221,10 +291,17 @@ public:
 
     void setFrame(int frameIndex, float time, const std::vector<int>& drawOrder);
 
+    int getSlotsCount() const { return m_slotsCount; }
+
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame
     {
         float time;
@@ -234,6 +311,9 @@ public:
     std::vector<Frame> frames;
 
 private:
+    // Returns the frame for the time or nullptr if the time is before the first frame
+    const Frame* getFrame(float time) const;
+
     const int m_slotsCount;
     int* m_drawOrderBuffer;
 };
@@ -247,10 +327,17 @@ public:
     void setFrame(int frameIndex, float time, const std::vector<Vector>& vertices);
     void setFrame(int frameIndex, float time, const std::vector<float>& vertices);
 
+    size_t getFrameVerticesCount() const { return m_frameVerticesCount; }
+
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -274,9 +361,14 @@ public:
     IkConstraintTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -286,6 +378,11 @@ public:
 
     std::vector<Frame> frames;
     int ikConstraintIndex = 0;
+
+private:
+    // Constraint is the constraint of a skeleton or its pose
+    template <typename Constraint>
+    void applyToConstraint(float time, float alpha, Constraint& constraint) const;
 };
 
 class TransformConstraintTimeline : public CurveTimeline
@@ -294,9 +391,14 @@ public:
     TransformConstraintTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -308,6 +410,11 @@ public:
 
     std::vector<Frame> frames;
     int transformConstraintIndex = 0;
+
+private:
+    // Constraint is the constraint of a skeleton or its pose
+    template <typename Constraint>
+    void applyToConstraint(float time, float alpha, Constraint& constraint) const;
 };
 
 class PathConstraintTimeline : public CurveTimeline
@@ -317,6 +424,10 @@ public:
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -336,6 +447,7 @@ public:
     PathConstraintPositionTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 };
 
 class PathConstraintSpacingTimeline : public PathConstraintTimeline
@@ -344,6 +456,7 @@ public:
     PathConstraintSpacingTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 };
 
 class PathConstraintMixTimeline : public CurveTimeline
@@ -352,9 +465,14 @@ public:
     PathConstraintMixTimeline(int framesCount);
 
     virtual void apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const override;
+    virtual void applyToPose(Pose& pose, float time, float alpha) const override;
 
     virtual void clearIdentityFrames() override;
 
+    virtual void addTargets(AnimationTargets& targets) const override;
+
+    virtual float getLastFrameTime() const override;
+
     struct Frame : public CurveFrame
     {
         float time;
@@ -364,6 +482,11 @@ public:
 
     std::vector<Frame> frames;
     int pathConstraintIndex = 0;
+
+private:
+    // Constraint is the constraint of a skeleton or its pose
+    template <typename Constraint>
+    void applyToConstraint(float time, float alpha, Constraint& constraint) const;
 };
 
 }
\ No newline at end of file
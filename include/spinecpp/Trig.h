@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cmath>
+
+namespace spine
+{
+
+// The implementation of the trigonometric functions used to calculate world transforms: by bones, constraints and
+// region attachments.
+enum class TrigBackend
+{
+    // std::sin, std::cos and std::atan2
+    Std,
+
+    // Inlined polynomial approximations without calls to the math library, and a sincos which computes both with one
+    // range reduction. The maximum absolute error is 8e-8 for sin and cos of |radians| < 1e4 (1e-6 up to 1e5, beyond
+    // which they aren't usable), and 3e-7 radians for atan2. World transforms differ from the ones with Std by a few
+    // ulps: less than 1e-5 in a, b, c and d, and less than 1e-5 of their distance from the origin in the world
+    // positions (checked by test/TrigBackendTest.cpp). Pays off where the library functions are slow (for example ARM).
+    Fast,
+};
+
+// The backend is process-wide, like Bone::setYDown. It's Std by default, or Fast if SPINECPP_FAST_TRIG is defined
+// when building the library. It shouldn't be changed while skeletons are being updated on other threads.
+void setTrigBackend(TrigBackend backend);
+TrigBackend getTrigBackend();
+
+namespace trig
+{
+
+extern TrigBackend backend;
+
+// Coefficients of the sine and cosine polynomials of the Cephes library, for x in [-pi/4, pi/4]. Also used by the
+// SIMD sine and cosine of BoneTransformStore.
+constexpr float SinCoefficients[] = { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f };
+constexpr float CosCoefficients[] = { 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f };
+
+// x + x^3 * (s2 + z * (s1 + z * s0)), with z = x^2
+inline float sinPoly(float x)
+{
+    float z = x * x;
+    return ((SinCoefficients[0] * z + SinCoefficients[1]) * z + SinCoefficients[2]) * z * x + x;
+}
+
+// 1 - z / 2 + z^2 * (c2 + z * (c1 + z * c0)), with z = x^2
+inline float cosPoly(float x)
+{
+    float z = x * x;
+    return ((CosCoefficients[0] * z + CosCoefficients[1]) * z + CosCoefficients[2]) * z * z - 0.5f * z + 1;
+}
+
+inline void fastSincos(float x, float& outSin, float& outCos)
+{
+    // x = q * pi/2 + r with r in [-pi/4, pi/4], with pi/2 split in three parts so that q * pi/2 is subtracted exactly
+    float fq = x * 0.636619772f;
+    int q = int(fq < 0 ? fq - 0.5f : fq + 0.5f);
+    float qf = float(q);
+    float r = ((x - qf * 1.5703125f) - qf * 4.837512969970703125e-4f) - qf * 7.54978995489188216e-8f;
+
+    float s = sinPoly(r), c = cosPoly(r);
+    switch (q & 3)
+    {
+    case 0:
+        outSin = s;
+        outCos = c;
+        break;
+    case 1:
+        outSin = c;
+        outCos = -s;
+        break;
+    case 2:
+        outSin = -s;
+        outCos = -c;
+        break;
+    default:
+        outSin = -c;
+        outCos = s;
+        break;
+    }
+}
+
+inline float fastSin(float x)
+{
+    float s, c;
+    fastSincos(x, s, c);
+    return s;
+}
+
+inline float fastCos(float x)
+{
+    float s, c;
+    fastSincos(x, s, c);
+    return c;
+}
+
+inline float fastAtan2(float y, float x)
+{
+    float ax = std::abs(x), ay = std::abs(y);
+    float mn = ax < ay ? ax : ay, mx = ax < ay ? ay : ax;
+    float t = mx > 0 ? mn / mx : 0;
+
+    // atan(t) for t in [0, 1] (Abramowitz and Stegun 4.4.49)
+    float z = t * t;
+    float r = (((((((0.0028662257f * z - 0.0161657367f) * z + 0.0429096138f) * z - 0.0752896400f) * z
+        + 0.1065626393f) * z - 0.1420889944f) * z + 0.1999355085f) * z - 0.3333314528f) * z * t + t;
+
+    if (ay > ax) r = 1.57079637f - r;
+    if (x < 0) r = 3.14159274f - r;
+    return std::copysign(r, y);
+}
+
+inline float sin(float x)
+{
+    return backend == TrigBackend::Fast ? fastSin(x) : std::sin(x);
+}
+
+inline float cos(float x)
+{
+    return backend == TrigBackend::Fast ? fastCos(x) : std::cos(x);
+}
+
+inline void sincos(float x, float& outSin, float& outCos)
+{
+    if (backend == TrigBackend::Fast)
+    {
+        fastSincos(x, outSin, outCos);
+    }
+    else
+    {
+        outSin = std::sin(x);
+        outCos = std::cos(x);
+    }
+}
+
+inline float atan2(float y, float x)
+{
+    return backend == TrigBackend::Fast ? fastAtan2(y, x) : std::atan2(y, x);
+}
+
+// Same as atan2, but Std computes in double precision, for the call sites which used the double std::atan2
+inline double atan2Double(float y, float x)
+{
+    return backend == TrigBackend::Fast ? double(fastAtan2(y, x)) : std::atan2(double(y), double(x));
+}
+
+}
+
+}
@@ -39,6 +39,7 @@ namespace spine
 {
 
 class Slot;
+struct BoneWorldTransform;
 
 class VertexAttachment : public Attachment
 {
@@ -46,6 +47,16 @@ public:
     void computeWorldVertices(const Slot& slot, float* outWorldVertices) const;
     void computeWorldVertices(int start, int count, const Slot& slot, float* outWorldVertices, int offset) const;
 
+    // Same as the above, but with the world transforms of the bones (by index) taken from transforms instead of the bones
+    // of the skeleton, for example the interpolated ones from Skeleton::interpolateWorldTransforms
+    void computeWorldVertices(const Slot& slot, const BoneWorldTransform* transforms, float* outWorldVertices) const;
+    void computeWorldVertices(int start, int count, const Slot& slot, const BoneWorldTransform* transforms, float* outWorldVertices, int offset) const;
+
+    // Same as the first two, but with the given translation instead of the one of the skeleton, for example the one of
+    // a crowd instance which shares the skeleton (see CrowdInstance::computeWorldVertices)
+    void computeWorldVertices(const Slot& slot, const Vector& translation, float* outWorldVertices) const;
+    void computeWorldVertices(int start, int count, const Slot& slot, const Vector& translation, float* outWorldVertices, int offset) const;
+
     // indices of bones int a skeleton
     chobo::vector_ptr<int> bones;
     
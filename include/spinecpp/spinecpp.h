@@ -32,17 +32,23 @@
 #pragma once
 
 #include <spinecpp/Animation.h>
+#include <spinecpp/AnimationMask.h>
 #include <spinecpp/AnimationState.h>
 #include <spinecpp/AnimationStateData.h>
 #include <spinecpp/Atlas.h>
 #include <spinecpp/AtlasAttachmentLoader.h>
 #include <spinecpp/Attachment.h>
 #include <spinecpp/AttachmentLoader.h>
+#include <spinecpp/BlendSpace.h>
 #include <spinecpp/Bone.h>
 #include <spinecpp/BoneData.h>
+#include <spinecpp/Pose.h>
+#include <spinecpp/PoseCache.h>
+#include <spinecpp/PoseLod.h>
 #include <spinecpp/RegionAttachment.h>
 #include <spinecpp/MeshAttachment.h>
 #include <spinecpp/BoundingBoxAttachment.h>
+#include <spinecpp/Crowd.h>
 #include <spinecpp/Skeleton.h>
 #include <spinecpp/SkeletonBounds.h>
 #include <spinecpp/SkeletonData.h>
@@ -50,5 +56,6 @@
 #include <spinecpp/Skin.h>
 #include <spinecpp/Slot.h>
 #include <spinecpp/SlotData.h>
+#include <spinecpp/Trig.h>
 #include <spinecpp/Event.h>
 #include <spinecpp/EventData.h>
@@ -31,12 +31,41 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <spinecpp/Animation.h>
 #include <spinecpp/Timeline.h>
+#include <spinecpp/QuantizedTimelines.h>
+#include <spinecpp/KeyframeReduction.h>
+#include <spinecpp/AnimationCache.h>
+#include <spinecpp/AnimationMask.h>
+#include <spinecpp/SkeletonData.h>
+#include <spinecpp/Skeleton.h>
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 
 namespace spine
 {
 
+void AnimationTargets::clear()
+{
+    bones.clear();
+    slots.clear();
+    ikConstraints.clear();
+    transformConstraints.clear();
+    pathConstraints.clear();
+    drawOrder = false;
+}
+
+AnimationTargets& AnimationTargets::operator|=(const AnimationTargets& other)
+{
+    bones |= other.bones;
+    slots |= other.slots;
+    ikConstraints |= other.ikConstraints;
+    transformConstraints |= other.transformConstraints;
+    pathConstraints |= other.pathConstraints;
+    drawOrder = drawOrder || other.drawOrder;
+    return *this;
+}
+
 Animation::Animation(const std::string& name)
     : name(name)
 {
@@ -56,6 +85,198 @@ void Animation::apply(Skeleton& skeleton, float lastTime, float time, int loop,
 }
 
 void Animation::mix(Skeleton& skeleton, float lastTime, float time, int loop, std::vector<const Event*>* outEvents, float alpha) const
+{
+    getLoopTimes(lastTime, time, loop);
+
+    if (m_cache)
+    {
+        m_cache->acquire(m_cacheIndex);
+    }
+
+    for (auto t : timelines)
+    {
+        t->apply(skeleton, lastTime, time, outEvents, alpha);
+    }
+}
+
+void Animation::mix(Skeleton& skeleton, float lastTime, float time, int loop, std::vector<const Event*>* outEvents, float alpha, const CompiledAnimationMask& mask) const
+{
+    getLoopTimes(lastTime, time, loop);
+
+    if (m_cache)
+    {
+        m_cache->acquire(m_cacheIndex);
+    }
+
+    // only now all timelines are present
+    assert(mask.weights.size() == timelines.size());
+
+    for (auto i : mask.timelines)
+    {
+        timelines[i]->apply(skeleton, lastTime, time, outEvents, alpha * mask.weights[i]);
+    }
+}
+
+void Animation::mixWithoutDeform(Skeleton& skeleton, float lastTime, float time, int loop, std::vector<const Event*>* outEvents, float alpha, const CompiledAnimationMask* mask) const
+{
+    getLoopTimes(lastTime, time, loop);
+
+    if (m_cache)
+    {
+        m_cache->acquire(m_cacheIndex);
+    }
+
+    assert(!mask || mask->weights.size() == timelines.size());
+
+    if (mask)
+    {
+        for (auto i : mask->timelines)
+        {
+            auto t = timelines[i];
+            if (t->getType() == Timeline::Type::Deform) continue;
+            t->apply(skeleton, lastTime, time, outEvents, alpha * mask->weights[i]);
+        }
+    }
+    else
+    {
+        for (auto t : timelines)
+        {
+            if (t->getType() == Timeline::Type::Deform) continue;
+            t->apply(skeleton, lastTime, time, outEvents, alpha);
+        }
+    }
+}
+
+void Animation::sampleInto(Pose& pose, float time, int loop) const
+{
+    mixInto(pose, time, loop, 1);
+}
+
+void Animation::mixInto(Pose& pose, float time, int loop, float alpha) const
+{
+    float lastTime = -1;
+    getLoopTimes(lastTime, time, loop);
+
+    if (m_cache)
+    {
+        m_cache->acquire(m_cacheIndex);
+    }
+
+    for (auto t : timelines)
+    {
+        t->applyToPose(pose, time, alpha);
+    }
+}
+
+void Animation::sampleBoneTransforms(const SkeletonData& data, const float* times, size_t numTimes, int loop, BonePose* outPoses) const
+{
+    lockTimelines();
+
+    size_t numBones = data.bones.size();
+    std::vector<size_t> frameHints(m_boneTimelines.size(), 0);
+
+    for (size_t s = 0; s < numTimes; ++s)
+    {
+        float lastTime = -1;
+        float time = times[s];
+        getLoopTimes(lastTime, time, loop);
+
+        auto poses = outPoses + s * numBones;
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            auto& bd = data.bones[i];
+            auto& pose = poses[i];
+            pose.translation = bd.translation;
+            pose.rotation = bd.rotation;
+            pose.scale = bd.scale;
+            pose.shear = bd.shear;
+        }
+
+        for (size_t i = 0; i < m_boneTimelines.size(); ++i)
+        {
+            auto& bt = m_boneTimelines[i];
+            timelines[bt.timelineIndex]->applyToBonePose(poses[bt.boneIndex], data.bones[bt.boneIndex], time, 1, &frameHints[i]);
+        }
+    }
+
+    unlockTimelines();
+}
+
+void Animation::sampleWorldTransforms(Skeleton& skeleton, const float* times, size_t numTimes, int loop, BoneWorldTransform* outTransforms) const
+{
+    lockTimelines();
+
+    // Constraints only change the world transforms, so the local transforms of the bones which aren't animated
+    // stay in the setup pose.
+    skeleton.setBonesToSetupPose();
+
+    AnimationTargets resetTargets;
+    resetTargets.bones |= targets.bones;
+    resetTargets.ikConstraints |= targets.ikConstraints;
+    resetTargets.transformConstraints |= targets.transformConstraints;
+    resetTargets.pathConstraints |= targets.pathConstraints;
+
+    std::vector<int> constraintTimelines;
+    for (auto i : m_otherTimelines)
+    {
+        switch (timelines[i]->getType())
+        {
+        case Timeline::Type::IkConstraint:
+        case Timeline::Type::TransformConstraint:
+        case Timeline::Type::PathConstraintPosition:
+        case Timeline::Type::PathConstraintSpacing:
+        case Timeline::Type::PathConstraintMix:
+            constraintTimelines.push_back(i);
+            break;
+        default:
+            break;
+        }
+    }
+
+    size_t numBones = skeleton.bones.size();
+    std::vector<size_t> frameHints(m_boneTimelines.size(), 0);
+
+    for (size_t s = 0; s < numTimes; ++s)
+    {
+        float lastTime = -1;
+        float time = times[s];
+        getLoopTimes(lastTime, time, loop);
+
+        skeleton.setToSetupPose(resetTargets);
+
+        for (size_t i = 0; i < m_boneTimelines.size(); ++i)
+        {
+            auto& bt = m_boneTimelines[i];
+            auto& bone = skeleton.bones[bt.boneIndex];
+            auto pose = bone.getPose();
+            timelines[bt.timelineIndex]->applyToBonePose(pose, bone.data, time, 1, &frameHints[i]);
+            bone.setPose(pose);
+        }
+
+        for (auto i : constraintTimelines)
+        {
+            timelines[i]->apply(skeleton, lastTime, time, nullptr, 1);
+        }
+
+        skeleton.updateWorldTransform();
+
+        auto transforms = outTransforms + s * numBones;
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            auto& bone = skeleton.bones[i];
+            auto& transform = transforms[i];
+            transform.a = bone.a;
+            transform.b = bone.b;
+            transform.c = bone.c;
+            transform.d = bone.d;
+            transform.worldPos = bone.worldPos;
+        }
+    }
+
+    unlockTimelines();
+}
+
+void Animation::getLoopTimes(float& lastTime, float& time, int loop) const
 {
     if (loop && duration)
     {
@@ -65,19 +286,126 @@ void Animation::mix(Skeleton& skeleton, float lastTime, float time, int loop, st
             lastTime = std::fmod(lastTime, duration);
         }
     }
+}
 
-    for (auto t : timelines)
+void Animation::lockTimelines() const
+{
+    if (m_cache)
     {
-        t->apply(skeleton, lastTime, time, outEvents, alpha);
+        m_cache->acquire(m_cacheIndex, true);
+    }
+}
+
+void Animation::unlockTimelines() const
+{
+    if (m_cache)
+    {
+        m_cache->unlock(m_cacheIndex);
     }
 }
 
 void Animation::clearIdentityFramesFromTimelines()
 {
+    assert(!m_cache); // the cache would restore the timelines it compressed
+
     for (auto t : timelines)
     {
         t->clearIdentityFrames();
     }
+
+    updateTargets();
+}
+
+int Animation::quantizeTimelines(const TimelineQuantization& settings)
+{
+    assert(!m_cache); // the cache would restore the timelines it compressed
+
+    int count = 0;
+    for (auto& t : timelines)
+    {
+        auto quantized = quantizeTimeline(*t, settings);
+        if (quantized)
+        {
+            delete t;
+            t = quantized;
+            ++count;
+        }
+    }
+
+    // the last keys may have moved to the frame grid
+    updateTargets();
+
+    return count;
+}
+
+size_t Animation::reduceKeyframes(const KeyframeReduction& settings, KeyframeReductionReport* outReport)
+{
+    assert(!m_cache); // the cache would restore the timelines it compressed
+
+    size_t count = 0;
+    std::vector<float> removedKeys;
+    for (size_t i = 0; i < timelines.size(); ++i)
+    {
+        removedKeys.clear();
+        float maxError = spine::reduceKeyframes(*timelines[i], settings, &removedKeys);
+
+        if (removedKeys.empty()) continue;
+
+        count += removedKeys.size();
+
+        if (outReport)
+        {
+            outReport->timelines.emplace_back();
+            auto& report = outReport->timelines.back();
+            report.timelineIndex = i;
+            report.type = timelines[i]->getType();
+            report.removedKeys.swap(removedKeys);
+            report.maxError = maxError;
+            outReport->removedKeys += report.removedKeys.size();
+        }
+    }
+
+    return count;
+}
+
+void Animation::updateTargets()
+{
+    if (m_cache)
+    {
+        // make sure all timelines are present
+        m_cache->acquire(m_cacheIndex);
+    }
+
+    targets.clear();
+    m_boneTimelines.clear();
+    m_otherTimelines.clear();
+    m_poseEndTime = 0;
+
+    for (size_t i = 0; i < timelines.size(); ++i)
+    {
+        auto t = timelines[i];
+        t->addTargets(targets);
+
+        if (t->getType() != Timeline::Type::Event)
+        {
+            m_poseEndTime = std::max(m_poseEndTime, t->getLastFrameTime());
+        }
+
+        int boneIndex = t->getBoneIndex();
+        if (boneIndex >= 0)
+        {
+            m_boneTimelines.push_back({ boneIndex, int(i) });
+        }
+        else
+        {
+            m_otherTimelines.push_back(int(i));
+        }
+    }
+
+    std::stable_sort(m_boneTimelines.begin(), m_boneTimelines.end(), [](const BoneTimeline& a, const BoneTimeline& b)
+    {
+        return a.boneIndex < b.boneIndex;
+    });
 }
 
 }
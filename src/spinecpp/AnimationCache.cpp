@@ -0,0 +1,1014 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/AnimationCache.h>
+#include <spinecpp/Animation.h>
+#include <spinecpp/Timelines.h>
+#include <spinecpp/SkeletonData.h>
+
+#include <cassert>
+#include <cstring>
+
+namespace spine
+{
+
+namespace
+{
+
+class BitWriter
+{
+public:
+    BitWriter(std::vector<uint8_t>& out)
+        : m_out(out)
+    {}
+
+    ~BitWriter()
+    {
+        if (m_count)
+        {
+            m_out.push_back(uint8_t(m_buffer));
+        }
+    }
+
+    // bits must be at most 32
+    void write(uint32_t value, int bits)
+    {
+        m_buffer |= uint64_t(value) << m_count;
+        m_count += bits;
+        while (m_count >= 8)
+        {
+            m_out.push_back(uint8_t(m_buffer));
+            m_buffer >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    void writeBool(bool b)
+    {
+        write(b, 1);
+    }
+
+    void writeVarUint(size_t value)
+    {
+        do
+        {
+            write(uint32_t(value & 0x7F), 7);
+            value >>= 7;
+            writeBool(value != 0);
+        } while (value);
+    }
+
+    // Writes the bits of the value xor-ed with the previous value of the same channel.
+    // Close values share their sign, exponent and high mantissa bits, so only the bits between the
+    // leading and the trailing zeroes of the xor are written.
+    void writeFloat(float value, uint32_t& prev)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, 4);
+        uint32_t x = bits ^ prev;
+        prev = bits;
+
+        if (!x)
+        {
+            writeBool(false);
+            return;
+        }
+
+        writeBool(true);
+
+        int lead = 0;
+        while (!(x & (0x80000000u >> lead))) ++lead;
+        int trail = 0;
+        while (!(x & (1u << trail))) ++trail;
+
+        int length = 32 - lead - trail;
+        write(uint32_t(trail), 5);
+        write(uint32_t(length - 1), 5);
+        write(x >> trail, length);
+    }
+
+    void writeString(const std::string& str)
+    {
+        writeVarUint(str.length());
+        for (auto c : str)
+        {
+            write(uint8_t(c), 8);
+        }
+    }
+
+private:
+    std::vector<uint8_t>& m_out;
+    uint64_t m_buffer = 0;
+    int m_count = 0;
+};
+
+class BitReader
+{
+public:
+    BitReader(const std::vector<uint8_t>& in)
+        : m_in(in)
+    {}
+
+    uint32_t read(int bits)
+    {
+        while (m_count < bits)
+        {
+            uint64_t byte = m_pos < m_in.size() ? m_in[m_pos] : 0;
+            ++m_pos;
+            m_buffer |= byte << m_count;
+            m_count += 8;
+        }
+
+        uint32_t value = uint32_t(m_buffer & ((uint64_t(1) << bits) - 1));
+        m_buffer >>= bits;
+        m_count -= bits;
+        return value;
+    }
+
+    bool readBool()
+    {
+        return !!read(1);
+    }
+
+    size_t readVarUint()
+    {
+        size_t value = 0;
+        int shift = 0;
+        bool more;
+        do
+        {
+            value |= size_t(read(7)) << shift;
+            shift += 7;
+            more = readBool();
+        } while (more);
+        return value;
+    }
+
+    float readFloat(uint32_t& prev)
+    {
+        if (readBool())
+        {
+            int trail = int(read(5));
+            int length = int(read(5)) + 1;
+            prev ^= read(length) << trail;
+        }
+
+        float value;
+        memcpy(&value, &prev, 4);
+        return value;
+    }
+
+    std::string readString()
+    {
+        std::string str(readVarUint(), 0);
+        for (auto& c : str)
+        {
+            c = char(read(8));
+        }
+        return str;
+    }
+
+private:
+    const std::vector<uint8_t>& m_in;
+    size_t m_pos = 0;
+    uint64_t m_buffer = 0;
+    int m_count = 0;
+};
+
+// Previous values of the channels of a timeline for the xor coding
+struct Channels
+{
+    Channels()
+    {
+        memset(this, 0, sizeof(Channels));
+    }
+
+    uint32_t time;
+    uint32_t curve[CurveFrame::BEZIER_DATA_SIZE * 2];
+    uint32_t values[4];
+};
+
+const int TYPE_BITS = 5;
+
+bool isCompressible(Timeline::Type type)
+{
+    switch (type)
+    {
+    case Timeline::Type::Rotate:
+    case Timeline::Type::Translate:
+    case Timeline::Type::Scale:
+    case Timeline::Type::Shear:
+    case Timeline::Type::Color:
+    case Timeline::Type::Attachment:
+    case Timeline::Type::Draworder:
+    case Timeline::Type::Deform:
+    case Timeline::Type::IkConstraint:
+    case Timeline::Type::TransformConstraint:
+    case Timeline::Type::PathConstraintPosition:
+    case Timeline::Type::PathConstraintSpacing:
+    case Timeline::Type::PathConstraintMix:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Finds the skin and the entry of an attachment in the skins of the data. Returns false if it's in none of them.
+bool findAttachment(const SkeletonData& data, const Attachment* attachment, size_t& outSkin, int& outEntry)
+{
+    for (size_t i = 0; i < data.skins.size(); ++i)
+    {
+        int entry = data.skins[i].getEntryIndex(attachment);
+        if (entry >= 0)
+        {
+            outSkin = i;
+            outEntry = entry;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Returns true if the timeline can be written to the compressed data
+bool isCompressible(const SkeletonData& data, const Timeline& timeline)
+{
+    if (!isCompressible(timeline.getType())) return false;
+    if (timeline.getType() != Timeline::Type::Deform) return true;
+
+    // the attachment is stored by its index in the skins, since its address is only valid in this process
+    auto attachment = static_cast<const DeformTimeline&>(timeline).attachment;
+    size_t skin;
+    int entry;
+    return !attachment || findAttachment(data, attachment, skin, entry);
+}
+
+void writeCurve(BitWriter& w, const CurveFrame& frame, Channels& ch)
+{
+    w.write(uint32_t(frame.type), 2);
+    if (frame.type != CurveFrame::Type::Bezier) return;
+
+    for (int i = 0; i < CurveFrame::BEZIER_DATA_SIZE; ++i)
+    {
+        w.writeFloat(frame.bezierData[i].x, ch.curve[2 * i]);
+        w.writeFloat(frame.bezierData[i].y, ch.curve[2 * i + 1]);
+    }
+}
+
+void readCurve(BitReader& r, CurveFrame& frame, Channels& ch)
+{
+    frame.type = CurveFrame::Type(r.read(2));
+    if (frame.type != CurveFrame::Type::Bezier) return;
+
+    for (int i = 0; i < CurveFrame::BEZIER_DATA_SIZE; ++i)
+    {
+        frame.bezierData[i].x = r.readFloat(ch.curve[2 * i]);
+        frame.bezierData[i].y = r.readFloat(ch.curve[2 * i + 1]);
+    }
+}
+
+// Writes the common parts of the frames of curve timelines. writeValues writes the rest.
+template <typename Frame, typename WriteValues>
+void writeCurveFrames(BitWriter& w, const std::vector<Frame>& frames, WriteValues writeValues)
+{
+    Channels ch;
+    w.writeVarUint(frames.size());
+    for (auto& f : frames)
+    {
+        w.writeFloat(f.time, ch.time);
+        writeCurve(w, f, ch);
+        writeValues(f, ch.values);
+    }
+}
+
+template <typename Frame, typename ReadValues>
+void readCurveFrames(BitReader& r, std::vector<Frame>& frames, ReadValues readValues)
+{
+    Channels ch;
+    for (auto& f : frames)
+    {
+        f.time = r.readFloat(ch.time);
+        readCurve(r, f, ch);
+        readValues(f, ch.values);
+    }
+}
+
+void writeVector(BitWriter& w, const Vector& v, uint32_t* prev)
+{
+    w.writeFloat(v.x, prev[0]);
+    w.writeFloat(v.y, prev[1]);
+}
+
+void readVector(BitReader& r, Vector& v, uint32_t* prev)
+{
+    v.x = r.readFloat(prev[0]);
+    v.y = r.readFloat(prev[1]);
+}
+
+void writeTimeline(BitWriter& w, const SkeletonData& data, const Timeline& timeline)
+{
+    switch (timeline.getType())
+    {
+    case Timeline::Type::Rotate:
+    {
+        auto& t = static_cast<const RotateTimeline&>(timeline);
+        w.writeVarUint(t.boneIndex);
+        writeCurveFrames(w, t.frames, [&w](const RotateTimeline::Frame& f, uint32_t* prev)
+        {
+            w.writeFloat(f.angle, prev[0]);
+        });
+        break;
+    }
+    case Timeline::Type::Translate:
+    {
+        auto& t = static_cast<const TranslateTimeline&>(timeline);
+        w.writeVarUint(t.boneIndex);
+        writeCurveFrames(w, t.frames, [&w](const TranslateTimeline::Frame& f, uint32_t* prev)
+        {
+            writeVector(w, f.translation, prev);
+        });
+        break;
+    }
+    case Timeline::Type::Scale:
+    {
+        auto& t = static_cast<const ScaleTimeline&>(timeline);
+        w.writeVarUint(t.boneIndex);
+        writeCurveFrames(w, t.frames, [&w](const ScaleTimeline::Frame& f, uint32_t* prev)
+        {
+            writeVector(w, f.scale, prev);
+        });
+        break;
+    }
+    case Timeline::Type::Shear:
+    {
+        auto& t = static_cast<const ShearTimeline&>(timeline);
+        w.writeVarUint(t.boneIndex);
+        writeCurveFrames(w, t.frames, [&w](const ShearTimeline::Frame& f, uint32_t* prev)
+        {
+            writeVector(w, f.shear, prev);
+        });
+        break;
+    }
+    case Timeline::Type::Color:
+    {
+        auto& t = static_cast<const ColorTimeline&>(timeline);
+        w.writeVarUint(t.slotIndex);
+        writeCurveFrames(w, t.frames, [&w](const ColorTimeline::Frame& f, uint32_t* prev)
+        {
+            w.writeFloat(f.color.r, prev[0]);
+            w.writeFloat(f.color.g, prev[1]);
+            w.writeFloat(f.color.b, prev[2]);
+            w.writeFloat(f.color.a, prev[3]);
+        });
+        break;
+    }
+    case Timeline::Type::Attachment:
+    {
+        auto& t = static_cast<const AttachmentTimeline&>(timeline);
+        w.writeVarUint(t.slotIndex);
+        w.writeVarUint(t.frames.size());
+        Channels ch;
+        const std::string* prevName = nullptr;
+        for (auto& f : t.frames)
+        {
+            w.writeFloat(f.time, ch.time);
+            bool same = prevName && *prevName == f.attachmentName;
+            w.writeBool(same);
+            if (!same)
+            {
+                w.writeString(f.attachmentName);
+            }
+            prevName = &f.attachmentName;
+        }
+        break;
+    }
+    case Timeline::Type::Draworder:
+    {
+        auto& t = static_cast<const DrawOrderTimeline&>(timeline);
+        w.writeVarUint(t.getSlotsCount());
+        w.writeVarUint(t.frames.size());
+        Channels ch;
+        for (auto& f : t.frames)
+        {
+            w.writeFloat(f.time, ch.time);
+            w.writeBool(!!f.drawOrder);
+            if (!f.drawOrder) continue;
+
+            // most slots are usually in their setup position
+            for (int i = 0; i < t.getSlotsCount(); ++i)
+            {
+                int offset = f.drawOrder[i] - i;
+                w.writeVarUint(size_t(offset < 0 ? ((-offset) << 1) - 1 : offset << 1));
+            }
+        }
+        break;
+    }
+    case Timeline::Type::Deform:
+    {
+        auto& t = static_cast<const DeformTimeline&>(timeline);
+        w.writeVarUint(t.slotIndex);
+
+        // the skin index + 1 (0 for no attachment) and the index of the attachment in the skin
+        size_t skin = 0;
+        int entry = 0;
+        if (t.attachment)
+        {
+            bool found = findAttachment(data, t.attachment, skin, entry);
+            assert(found); // see isCompressible
+            (void)found;
+            w.writeVarUint(skin + 1);
+            w.writeVarUint(size_t(entry));
+        }
+        else
+        {
+            w.writeVarUint(0);
+        }
+
+        auto numVertices = t.getFrameVerticesCount();
+        w.writeVarUint(numVertices);
+
+        // each vertex component is coded against the same component in the previous frame
+        std::vector<uint32_t> prevVertices(numVertices * 2, 0);
+        writeCurveFrames(w, t.frames, [&w, &prevVertices, numVertices](const DeformTimeline::Frame& f, uint32_t*)
+        {
+            for (size_t i = 0; i < numVertices; ++i)
+            {
+                writeVector(w, f.vertices[i], prevVertices.data() + 2 * i);
+            }
+        });
+        break;
+    }
+    case Timeline::Type::IkConstraint:
+    {
+        auto& t = static_cast<const IkConstraintTimeline&>(timeline);
+        w.writeVarUint(t.ikConstraintIndex);
+        writeCurveFrames(w, t.frames, [&w](const IkConstraintTimeline::Frame& f, uint32_t* prev)
+        {
+            w.writeFloat(f.mix, prev[0]);
+            w.writeBool(f.bendDirection > 0);
+        });
+        break;
+    }
+    case Timeline::Type::TransformConstraint:
+    {
+        auto& t = static_cast<const TransformConstraintTimeline&>(timeline);
+        w.writeVarUint(t.transformConstraintIndex);
+        writeCurveFrames(w, t.frames, [&w](const TransformConstraintTimeline::Frame& f, uint32_t* prev)
+        {
+            w.writeFloat(f.rotateMix, prev[0]);
+            w.writeFloat(f.translateMix, prev[1]);
+            w.writeFloat(f.scaleMix, prev[2]);
+            w.writeFloat(f.shearMix, prev[3]);
+        });
+        break;
+    }
+    case Timeline::Type::PathConstraintPosition:
+    case Timeline::Type::PathConstraintSpacing:
+    {
+        auto& t = static_cast<const PathConstraintTimeline&>(timeline);
+        w.writeVarUint(t.pathConstraintIndex);
+        writeCurveFrames(w, t.frames, [&w](const PathConstraintTimeline::Frame& f, uint32_t* prev)
+        {
+            w.writeFloat(f.value, prev[0]);
+        });
+        break;
+    }
+    case Timeline::Type::PathConstraintMix:
+    {
+        auto& t = static_cast<const PathConstraintMixTimeline&>(timeline);
+        w.writeVarUint(t.pathConstraintIndex);
+        writeCurveFrames(w, t.frames, [&w](const PathConstraintMixTimeline::Frame& f, uint32_t* prev)
+        {
+            w.writeFloat(f.rotateMix, prev[0]);
+            w.writeFloat(f.translateMix, prev[1]);
+        });
+        break;
+    }
+    default:
+        assert(false); // not compressible
+    }
+}
+
+Timeline* readTimeline(BitReader& r, const SkeletonData& data, Timeline::Type type)
+{
+    switch (type)
+    {
+    case Timeline::Type::Rotate:
+    {
+        int boneIndex = int(r.readVarUint());
+        auto t = new RotateTimeline(int(r.readVarUint()));
+        t->boneIndex = boneIndex;
+        readCurveFrames(r, t->frames, [&r](RotateTimeline::Frame& f, uint32_t* prev)
+        {
+            f.angle = r.readFloat(prev[0]);
+        });
+        return t;
+    }
+    case Timeline::Type::Translate:
+    {
+        int boneIndex = int(r.readVarUint());
+        auto t = new TranslateTimeline(int(r.readVarUint()));
+        t->boneIndex = boneIndex;
+        readCurveFrames(r, t->frames, [&r](TranslateTimeline::Frame& f, uint32_t* prev)
+        {
+            readVector(r, f.translation, prev);
+        });
+        return t;
+    }
+    case Timeline::Type::Scale:
+    {
+        int boneIndex = int(r.readVarUint());
+        auto t = new ScaleTimeline(int(r.readVarUint()));
+        t->boneIndex = boneIndex;
+        readCurveFrames(r, t->frames, [&r](ScaleTimeline::Frame& f, uint32_t* prev)
+        {
+            readVector(r, f.scale, prev);
+        });
+        return t;
+    }
+    case Timeline::Type::Shear:
+    {
+        int boneIndex = int(r.readVarUint());
+        auto t = new ShearTimeline(int(r.readVarUint()));
+        t->boneIndex = boneIndex;
+        readCurveFrames(r, t->frames, [&r](ShearTimeline::Frame& f, uint32_t* prev)
+        {
+            readVector(r, f.shear, prev);
+        });
+        return t;
+    }
+    case Timeline::Type::Color:
+    {
+        int slotIndex = int(r.readVarUint());
+        auto t = new ColorTimeline(int(r.readVarUint()));
+        t->slotIndex = slotIndex;
+        readCurveFrames(r, t->frames, [&r](ColorTimeline::Frame& f, uint32_t* prev)
+        {
+            f.color.r = r.readFloat(prev[0]);
+            f.color.g = r.readFloat(prev[1]);
+            f.color.b = r.readFloat(prev[2]);
+            f.color.a = r.readFloat(prev[3]);
+        });
+        return t;
+    }
+    case Timeline::Type::Attachment:
+    {
+        auto t = new AttachmentTimeline;
+        t->slotIndex = int(r.readVarUint());
+        auto numFrames = r.readVarUint();
+        t->frames.reserve(numFrames);
+        Channels ch;
+        for (size_t i = 0; i < numFrames; ++i)
+        {
+            float time = r.readFloat(ch.time);
+            if (r.readBool())
+            {
+                t->frames.emplace_back(time, t->frames.back().attachmentName);
+            }
+            else
+            {
+                t->frames.emplace_back(time, r.readString());
+            }
+        }
+        return t;
+    }
+    case Timeline::Type::Draworder:
+    {
+        int slotsCount = int(r.readVarUint());
+        int numFrames = int(r.readVarUint());
+        auto t = new DrawOrderTimeline(numFrames, slotsCount);
+        std::vector<int> drawOrder;
+        Channels ch;
+        for (int f = 0; f < numFrames; ++f)
+        {
+            float time = r.readFloat(ch.time);
+            drawOrder.clear();
+            if (r.readBool())
+            {
+                drawOrder.resize(slotsCount);
+                for (int i = 0; i < slotsCount; ++i)
+                {
+                    auto zigzag = r.readVarUint();
+                    int offset = zigzag & 1 ? -int((zigzag + 1) >> 1) : int(zigzag >> 1);
+                    drawOrder[i] = i + offset;
+                }
+            }
+            t->setFrame(f, time, drawOrder);
+        }
+        return t;
+    }
+    case Timeline::Type::Deform:
+    {
+        int slotIndex = int(r.readVarUint());
+        const Attachment* attachment = nullptr;
+        if (auto skin = r.readVarUint())
+        {
+            attachment = data.skins[skin - 1].getEntryAttachment(int(r.readVarUint()));
+        }
+        auto numVertices = r.readVarUint();
+        auto numFrames = int(r.readVarUint());
+
+        auto t = new DeformTimeline(numFrames, numVertices);
+        t->slotIndex = slotIndex;
+        t->attachment = attachment;
+
+        std::vector<uint32_t> prevVertices(numVertices * 2, 0);
+        readCurveFrames(r, t->frames, [&r, &prevVertices, numVertices](DeformTimeline::Frame& f, uint32_t*)
+        {
+            for (size_t i = 0; i < numVertices; ++i)
+            {
+                readVector(r, f.vertices[i], prevVertices.data() + 2 * i);
+            }
+        });
+        return t;
+    }
+    case Timeline::Type::IkConstraint:
+    {
+        int index = int(r.readVarUint());
+        auto t = new IkConstraintTimeline(int(r.readVarUint()));
+        t->ikConstraintIndex = index;
+        readCurveFrames(r, t->frames, [&r](IkConstraintTimeline::Frame& f, uint32_t* prev)
+        {
+            f.mix = r.readFloat(prev[0]);
+            f.bendDirection = r.readBool() ? 1 : -1;
+        });
+        return t;
+    }
+    case Timeline::Type::TransformConstraint:
+    {
+        int index = int(r.readVarUint());
+        auto t = new TransformConstraintTimeline(int(r.readVarUint()));
+        t->transformConstraintIndex = index;
+        readCurveFrames(r, t->frames, [&r](TransformConstraintTimeline::Frame& f, uint32_t* prev)
+        {
+            f.rotateMix = r.readFloat(prev[0]);
+            f.translateMix = r.readFloat(prev[1]);
+            f.scaleMix = r.readFloat(prev[2]);
+            f.shearMix = r.readFloat(prev[3]);
+        });
+        return t;
+    }
+    case Timeline::Type::PathConstraintPosition:
+    case Timeline::Type::PathConstraintSpacing:
+    {
+        int index = int(r.readVarUint());
+        int numFrames = int(r.readVarUint());
+        PathConstraintTimeline* t;
+        if (type == Timeline::Type::PathConstraintPosition)
+        {
+            t = new PathConstraintPositionTimeline(numFrames);
+        }
+        else
+        {
+            t = new PathConstraintSpacingTimeline(numFrames);
+        }
+        t->pathConstraintIndex = index;
+        readCurveFrames(r, t->frames, [&r](PathConstraintTimeline::Frame& f, uint32_t* prev)
+        {
+            f.value = r.readFloat(prev[0]);
+        });
+        return t;
+    }
+    case Timeline::Type::PathConstraintMix:
+    {
+        int index = int(r.readVarUint());
+        auto t = new PathConstraintMixTimeline(int(r.readVarUint()));
+        t->pathConstraintIndex = index;
+        readCurveFrames(r, t->frames, [&r](PathConstraintMixTimeline::Frame& f, uint32_t* prev)
+        {
+            f.rotateMix = r.readFloat(prev[0]);
+            f.translateMix = r.readFloat(prev[1]);
+        });
+        return t;
+    }
+    default:
+        assert(false); // not compressible
+        return nullptr;
+    }
+}
+
+template <typename T>
+size_t curveTimelineSize(const Timeline& timeline)
+{
+    auto& t = static_cast<const T&>(timeline);
+    return sizeof(T) + t.frames.capacity() * sizeof(typename T::Frame)
+        + t.frames.size() * CurveFrame::BEZIER_DATA_SIZE * sizeof(Vector);
+}
+
+// estimated size of a decompressed timeline
+size_t timelineSize(const Timeline& timeline)
+{
+    switch (timeline.getType())
+    {
+    case Timeline::Type::Rotate: return curveTimelineSize<RotateTimeline>(timeline);
+    case Timeline::Type::Translate: return curveTimelineSize<TranslateTimeline>(timeline);
+    case Timeline::Type::Scale: return curveTimelineSize<ScaleTimeline>(timeline);
+    case Timeline::Type::Shear: return curveTimelineSize<ShearTimeline>(timeline);
+    case Timeline::Type::Color: return curveTimelineSize<ColorTimeline>(timeline);
+    case Timeline::Type::IkConstraint: return curveTimelineSize<IkConstraintTimeline>(timeline);
+    case Timeline::Type::TransformConstraint: return curveTimelineSize<TransformConstraintTimeline>(timeline);
+    case Timeline::Type::PathConstraintPosition: return curveTimelineSize<PathConstraintPositionTimeline>(timeline);
+    case Timeline::Type::PathConstraintSpacing: return curveTimelineSize<PathConstraintSpacingTimeline>(timeline);
+    case Timeline::Type::PathConstraintMix: return curveTimelineSize<PathConstraintMixTimeline>(timeline);
+    case Timeline::Type::Attachment:
+    {
+        auto& t = static_cast<const AttachmentTimeline&>(timeline);
+        size_t size = sizeof(AttachmentTimeline) + t.frames.capacity() * sizeof(AttachmentTimeline::Frame);
+        for (auto& f : t.frames)
+        {
+            size += f.attachmentName.capacity();
+        }
+        return size;
+    }
+    case Timeline::Type::Draworder:
+    {
+        auto& t = static_cast<const DrawOrderTimeline&>(timeline);
+        return sizeof(DrawOrderTimeline) + t.frames.size() * (sizeof(DrawOrderTimeline::Frame) + t.getSlotsCount() * sizeof(int));
+    }
+    case Timeline::Type::Deform:
+    {
+        auto& t = static_cast<const DeformTimeline&>(timeline);
+        return curveTimelineSize<DeformTimeline>(timeline) + t.frames.size() * t.getFrameVerticesCount() * sizeof(Vector);
+    }
+    default:
+        return 0;
+    }
+}
+
+}
+
+AnimationCache::AnimationCache(const SkeletonData& data)
+    : m_data(data)
+{
+}
+
+AnimationCache::~AnimationCache()
+{
+    // The animations own their timelines and remain valid after the cache is destroyed, so the evicted ones get their
+    // compressed timelines back. The cache of a SkeletonData is destroyed before its animations.
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        auto& entry = m_entries[i];
+        if (!entry.resident)
+        {
+            decompress(int(i));
+        }
+        entry.animation->m_cache = nullptr;
+    }
+}
+
+void AnimationCache::add(Animation& animation)
+{
+    assert(!animation.m_cache);
+
+    int index = int(m_entries.size());
+    m_entries.emplace_back();
+    auto& entry = m_entries.back();
+    entry.animation = &animation;
+
+    {
+        BitWriter w(entry.data);
+        w.writeVarUint(animation.timelines.size());
+        for (auto t : animation.timelines)
+        {
+            auto type = t->getType();
+            w.write(uint32_t(type), TYPE_BITS);
+
+            bool compressible = isCompressible(m_data, *t);
+            w.writeBool(compressible);
+            entry.compressed.push_back(compressible);
+            if (compressible)
+            {
+                writeTimeline(w, m_data, *t);
+            }
+        }
+    }
+
+    entry.data.shrink_to_fit();
+    m_stats.compressedBytes += entry.data.size();
+
+    animation.m_cache = this;
+    animation.m_cacheIndex = index;
+
+    // the animation was resident until now
+    entry.resident = true;
+    evict(index);
+}
+
+void AnimationCache::setBudget(size_t bytes)
+{
+    m_budget = bytes;
+
+    int victim = m_tail;
+    while (m_stats.residentBytes > m_budget && victim != -1)
+    {
+        int prev = m_entries[victim].prev;
+        if (!m_entries[victim].locks)
+        {
+            evict(victim);
+        }
+        victim = prev;
+    }
+}
+
+void AnimationCache::evictAll()
+{
+    int victim = m_tail;
+    while (victim != -1)
+    {
+        int prev = m_entries[victim].prev;
+        if (!m_entries[victim].locks)
+        {
+            evict(victim);
+        }
+        victim = prev;
+    }
+}
+
+void AnimationCache::resetCounters()
+{
+    m_stats.hits = 0;
+    m_stats.misses = 0;
+    m_stats.evictions = 0;
+}
+
+void AnimationCache::acquire(int index, bool lock)
+{
+    auto& entry = m_entries[index];
+    if (lock)
+    {
+        ++entry.locks;
+    }
+
+    if (entry.resident)
+    {
+        ++m_stats.hits;
+        if (m_head != index)
+        {
+            unlink(index);
+            linkFront(index);
+        }
+        return;
+    }
+
+    ++m_stats.misses;
+    decompress(index);
+    linkFront(index);
+
+    int victim = m_tail;
+    while (m_stats.residentBytes > m_budget && victim != index)
+    {
+        int prev = m_entries[victim].prev;
+        if (!m_entries[victim].locks)
+        {
+            evict(victim);
+        }
+        victim = prev;
+    }
+}
+
+void AnimationCache::unlock(int index)
+{
+    assert(m_entries[index].locks > 0);
+    --m_entries[index].locks;
+}
+
+void AnimationCache::evict(int index)
+{
+    auto& entry = m_entries[index];
+    if (!entry.resident) return;
+
+    if (entry.prev != -1 || entry.next != -1 || m_head == index)
+    {
+        unlink(index);
+        ++m_stats.evictions;
+    }
+
+    // keep only the timelines which aren't in the compressed data
+    auto& timelines = entry.animation->timelines;
+    assert(timelines.size() == entry.compressed.size());
+    size_t numPinned = 0;
+    for (size_t i = 0; i < timelines.size(); ++i)
+    {
+        auto t = timelines[i];
+        if (entry.compressed[i])
+        {
+            delete t;
+        }
+        else
+        {
+            timelines[numPinned++] = t;
+        }
+    }
+    timelines.resize(numPinned);
+    timelines.shrink_to_fit();
+
+    m_stats.residentBytes -= entry.residentSize;
+    entry.residentSize = 0;
+    entry.resident = false;
+}
+
+void AnimationCache::decompress(int index)
+{
+    auto& entry = m_entries[index];
+    assert(!entry.resident);
+
+    auto& timelines = entry.animation->timelines;
+    std::vector<Timeline*> pinned;
+    pinned.swap(timelines);
+
+    BitReader r(entry.data);
+    size_t nextPinned = 0;
+    size_t size = 0;
+    auto numTimelines = r.readVarUint();
+    timelines.reserve(numTimelines);
+    for (size_t i = 0; i < numTimelines; ++i)
+    {
+        auto type = Timeline::Type(r.read(TYPE_BITS));
+        if (r.readBool())
+        {
+            auto t = readTimeline(r, m_data, type);
+            size += timelineSize(*t);
+            timelines.push_back(t);
+        }
+        else
+        {
+            assert(nextPinned < pinned.size());
+            timelines.push_back(pinned[nextPinned++]);
+        }
+    }
+
+    entry.residentSize = size;
+    entry.resident = true;
+    m_stats.residentBytes += size;
+}
+
+void AnimationCache::linkFront(int index)
+{
+    auto& entry = m_entries[index];
+    entry.prev = -1;
+    entry.next = m_head;
+    if (m_head != -1)
+    {
+        m_entries[m_head].prev = index;
+    }
+    m_head = index;
+    if (m_tail == -1)
+    {
+        m_tail = index;
+    }
+}
+
+void AnimationCache::unlink(int index)
+{
+    auto& entry = m_entries[index];
+    if (entry.prev != -1)
+    {
+        m_entries[entry.prev].next = entry.next;
+    }
+    else
+    {
+        m_head = entry.next;
+    }
+
+    if (entry.next != -1)
+    {
+        m_entries[entry.next].prev = entry.prev;
+    }
+    else
+    {
+        m_tail = entry.prev;
+    }
+
+    entry.prev = entry.next = -1;
+}
+
+}
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/AnimationMask.h>
+#include <spinecpp/SkeletonData.h>
+#include <spinecpp/Timeline.h>
+
+#include <algorithm>
+
+namespace spine
+{
+
+void CompiledAnimationMask::clear()
+{
+    timelines.clear();
+    weights.clear();
+}
+
+AnimationMask::AnimationMask(const SkeletonData& data)
+    : data(data)
+    , boneWeights(data.bones.size(), 1)
+    , slotWeights(data.slots.size(), 1)
+{
+}
+
+void AnimationMask::setAllWeights(float weight)
+{
+    std::fill(boneWeights.begin(), boneWeights.end(), weight);
+    std::fill(slotWeights.begin(), slotWeights.end(), weight);
+}
+
+void AnimationMask::setBoneTreeWeight(int boneIndex, float weight)
+{
+    // parents always come before their children
+    BitSet tree;
+    tree.set(boneIndex);
+    for (size_t i = boneIndex + 1; i < data.bones.size(); ++i)
+    {
+        auto parent = data.bones[i].parent;
+        if (parent && tree.test(parent->index))
+        {
+            tree.set(i);
+        }
+    }
+
+    tree.forEach([this, weight](size_t i)
+    {
+        boneWeights[i] = weight;
+    });
+
+    for (auto& slot : data.slots)
+    {
+        if (tree.test(slot.boneData->index))
+        {
+            slotWeights[slot.index] = weight;
+        }
+    }
+}
+
+void AnimationMask::compile(const Animation& animation, CompiledAnimationMask& out) const
+{
+    out.clear();
+
+    animation.lockTimelines();
+
+    AnimationTargets targets;
+    for (size_t i = 0; i < animation.timelines.size(); ++i)
+    {
+        // timelines target at most one bone or slot
+        targets.clear();
+        animation.timelines[i]->addTargets(targets);
+
+        float weight = 1;
+        targets.bones.forEach([this, &weight](size_t bone)
+        {
+            weight = boneWeights[bone];
+        });
+        targets.slots.forEach([this, &weight](size_t slot)
+        {
+            weight = slotWeights[slot];
+        });
+
+        out.weights.push_back(weight);
+        if (weight != 0)
+        {
+            out.timelines.push_back(int(i));
+        }
+    }
+
+    animation.unlockTimelines();
+}
+
+}
@@ -33,9 +33,15 @@
 #include <spinecpp/Animation.h>
 #include <spinecpp/SkeletonData.h>
 #include <spinecpp/AnimationStateData.h>
+#include <spinecpp/Event.h>
+#include <spinecpp/Skeleton.h>
+#include <spinecpp/Timeline.h>
+#include <spinecpp/Timelines.h>
 #include <spinecpp/TrackEntryFactory.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
 
 namespace spine
 {
@@ -43,9 +49,25 @@ namespace spine
 TrackEntry::TrackEntry(const AnimationState& state, const Animation& anim)
     : state(state)
     , animation(anim)
+    , mixMode(state.defaultMixMode)
 {
 }
 
+void TrackEntry::setMask(const AnimationMask* m)
+{
+    if (m)
+    {
+        m->compile(animation, mask);
+    }
+    else
+    {
+        mask.clear();
+    }
+
+    requiredBonesVersion = 0;
+    ++maskVersion;
+}
+
 TrackEntry::~TrackEntry()
 {
     if (previous)
@@ -72,6 +94,192 @@ class DefaultTrackEntryFactory : public TrackEntryFactory
 
 } defaultTrackEntryFactory;
 
+// The velocity of frozen poses is estimated from the pose of the previous animation this much earlier
+const float FROZEN_VELOCITY_TIME_STEP = 1 / 30.f;
+
+enum BoneProperty
+{
+    Bone_Translation = 1,
+    Bone_Rotation = 2,
+    Bone_Scale = 4,
+    Bone_Shear = 8,
+};
+
+int getBoneProperty(Timeline::Type type)
+{
+    switch (type)
+    {
+    case Timeline::Type::Translate:
+    case Timeline::Type::QuantizedTranslate:
+        return Bone_Translation;
+    case Timeline::Type::Rotate:
+    case Timeline::Type::QuantizedRotate:
+        return Bone_Rotation;
+    case Timeline::Type::Scale:
+    case Timeline::Type::QuantizedScale:
+        return Bone_Scale;
+    case Timeline::Type::Shear:
+    case Timeline::Type::QuantizedShear:
+        return Bone_Shear;
+    default:
+        return 0;
+    }
+}
+
+// Returns the mask with which the animation of the entry is applied to the skeleton: the mask of the entry, restricted
+// to the required bones of the skeleton if it has them. Null if the animation isn't masked.
+const CompiledAnimationMask* getEntryMask(TrackEntry& entry, const Skeleton& skeleton)
+{
+    auto required = skeleton.getRequiredBonesMask();
+    if (!required)
+    {
+        return entry.mask.empty() ? nullptr : &entry.mask;
+    }
+
+    if (entry.requiredBonesVersion != skeleton.getRequiredBonesVersion())
+    {
+        auto& out = entry.requiredBonesMask;
+        required->compile(entry.animation, out);
+
+        if (!entry.mask.empty())
+        {
+            out.timelines.clear();
+            for (size_t i = 0; i < out.weights.size(); ++i)
+            {
+                out.weights[i] *= entry.mask.weights[i];
+                if (out.weights[i] != 0) out.timelines.push_back(int(i));
+            }
+        }
+
+        entry.requiredBonesVersion = skeleton.getRequiredBonesVersion();
+    }
+
+    return &entry.requiredBonesMask;
+}
+
+// Mixes the animation of an entry, weighted by the mask of the entry if it has one
+void mixEntry(TrackEntry& entry, Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* events, float alpha)
+{
+    auto mask = getEntryMask(entry, skeleton);
+
+    if (!entry.state.applyDeform)
+    {
+        entry.animation.mixWithoutDeform(skeleton, lastTime, time, entry.loop, events, alpha, mask);
+    }
+    else if (!mask)
+    {
+        entry.animation.mix(skeleton, lastTime, time, entry.loop, events, alpha);
+    }
+    else
+    {
+        entry.animation.mix(skeleton, lastTime, time, entry.loop, events, alpha, *mask);
+    }
+}
+
+// Returns true if the animation of the entry doesn't change the pose at the time anymore
+bool isPoseSettled(const TrackEntry& entry, float time)
+{
+    auto& animation = entry.animation;
+    if (entry.loop && animation.duration)
+    {
+        time = std::fmod(time, animation.duration);
+    }
+
+    return time >= animation.getPoseEndTime();
+}
+
+// Returns the time of the first event key of the entry after the time, or infinity if there is none
+float getNextEventKeyTime(const TrackEntry& entry, float time)
+{
+    auto& animation = entry.animation;
+    float result = std::numeric_limits<float>::infinity();
+
+    bool loop = entry.loop && animation.duration;
+    float loopStart = 0;
+    if (loop)
+    {
+        float loopTime = std::fmod(time, animation.duration);
+        loopStart = time - loopTime;
+        time = loopTime;
+    }
+
+    // Event timelines are never compressed, so they are in the timelines of animations in a cache too.
+    for (auto t : animation.timelines)
+    {
+        if (t->getType() != Timeline::Type::Event) continue;
+
+        auto& frames = static_cast<const EventTimeline*>(t)->frames;
+        if (frames.empty()) continue;
+
+        auto frame = std::upper_bound(frames.begin(), frames.end(), time, [](float time, const Event& frame)
+        {
+            return time < frame.time;
+        });
+
+        float keyTime;
+        if (frame != frames.end())
+        {
+            keyTime = loopStart + frame->time;
+        }
+        else if (loop)
+        {
+            // the first key of the next loop
+            keyTime = loopStart + animation.duration + frames.front().time;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (!entry.loop && keyTime > entry.endTime) continue; // apply doesn't go past the end time
+
+        result = std::min(result, keyTime);
+    }
+
+    return result;
+}
+
+// Returns the delta for AnimationState::update which brings the time of the entry from its current time to at least
+// targetTime. The time is advanced like update does it, so the result is exact.
+float getDeltaToTime(float stateTimeScale, const TrackEntry& entry, float targetTime)
+{
+    if (stateTimeScale * entry.timeScale <= 0)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    float time = entry.time;
+    if (targetTime <= time)
+    {
+        // the target was rounded to the current time, it's reached with the smallest advance
+        targetTime = std::nextafter(time, std::numeric_limits<float>::infinity());
+    }
+
+    // the division may be off by a bit in either direction
+    float delta = (targetTime - time) / (stateTimeScale * entry.timeScale);
+    while (time + delta * stateTimeScale * entry.timeScale < targetTime)
+    {
+        delta = std::nextafter(delta, std::numeric_limits<float>::infinity());
+    }
+
+    while (delta > 0)
+    {
+        float smaller = std::nextafter(delta, 0.f);
+        if (time + smaller * stateTimeScale * entry.timeScale < targetTime) break;
+        delta = smaller;
+    }
+
+    return delta;
+}
+
+inline void normalizeAngle(float& angle)
+{
+    while (angle > 180)
+        angle -= 360;
+    while (angle < -180)
+        angle += 360;
+}
+
 }
 
 AnimationState::AnimationState(const AnimationStateData& data, TrackEntryFactory* factory)
@@ -130,6 +338,8 @@ void AnimationState::update(float delta)
 
 void AnimationState::apply(Skeleton& skeleton)
 {
+    m_appliedTracks.assign(tracks.size(), AppliedTrack());
+
     for (size_t i = 0; i < tracks.size(); ++i)
     {
         auto current = tracks[i];
@@ -143,10 +353,14 @@ void AnimationState::apply(Skeleton& skeleton)
             time = current->endTime;
         }
 
+        recordAppliedTrack(int(i), *current, time, skeleton);
+
         auto previous = current->previous;
+        m_appliedTargets |= current->animation.targets;
+
         if (!previous)
         {
-            current->animation.mix(skeleton, current->lastTime, time, current->loop, &m_events, current->mix);
+            mixEntry(*current, skeleton, current->lastTime, time, &m_events, current->mix);
         }
         else
         {
@@ -158,7 +372,20 @@ void AnimationState::apply(Skeleton& skeleton)
                 previousTime = previous->endTime;
             }
 
-            previous->animation.apply(skeleton, previousTime, previousTime, previous->loop, nullptr);
+            if (current->mixMode == MixMode::Evaluate)
+            {
+                mixEntry(*previous, skeleton, previousTime, previousTime, nullptr, 1);
+            }
+            else
+            {
+                if (!current->previousFrozen)
+                {
+                    freezePrevious(skeleton, int(i), *current, previousTime);
+                }
+
+                applyFrozenPose(skeleton, int(i), *current);
+            }
+            m_appliedTargets |= previous->animation.targets;
 
             if (alpha >= 1)
             {
@@ -167,74 +394,635 @@ void AnimationState::apply(Skeleton& skeleton)
                 current->previous = nullptr;
             }
 
-            current->animation.mix(skeleton, current->lastTime, time, current->loop, &m_events, alpha);
+            mixEntry(*current, skeleton, current->lastTime, time, &m_events, alpha);
         }
 
-        bool entryChanged = false;
-        for (auto& event : m_events)
+        dispatchEvents(int(i), current, time, 0, m_events.size());
+    }
+}
+
+void AnimationState::applyFused(Skeleton& skeleton)
+{
+    m_events.clear();
+    m_fusedEntries.clear();
+    m_fusedTracks.clear();
+    m_appliedTracks.assign(tracks.size(), AppliedTrack());
+
+    // collect the entries in the order in which apply would apply them
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        auto current = tracks[i];
+        if (!current) continue;
+
+        float time = current->time;
+        if (!current->loop && time > current->endTime)
+        {
+            time = current->endTime;
+        }
+
+        recordAppliedTrack(int(i), *current, time, skeleton);
+
+        float alpha = current->mix;
+
+        auto previous = current->previous;
+        if (previous)
         {
-            if (current->listener)
+            alpha = current->mixTime / current->mixDuration * current->mix;
+
+            float previousTime = previous->time;
+            if (!previous->loop && previousTime > previous->endTime)
             {
-                current->listener(*this, int(i), EventType::Anim_Event, event, 0);
+                previousTime = previous->endTime;
+            }
+
+            addFusedEntry(*previous, skeleton, previousTime, previousTime, 1, -1);
+            m_appliedTargets |= previous->animation.targets;
 
-                if (tracks[i] != current)
+            if (current->mixMode != MixMode::Evaluate)
+            {
+                if (!current->previousFrozen)
                 {
-                    // event changed current animation (tracks[i]), so stop processing it
-                    entryChanged = true;
-                    break;
+                    freezePrevious(skeleton, int(i), *current, previousTime);
                 }
+
+                m_fusedEntries.back().frozen = current;
+                m_fusedEntries.back().frozenIndex = int(i);
+            }
+
+            if (alpha >= 1)
+            {
+                // the fused entry refers to the mask of previous, so it's destroyed after the pose is applied
+                alpha = 1;
+                m_fusedDisposedEntries.push_back(current->previous);
+                current->previous = nullptr;
+            }
+        }
+
+        addFusedEntry(*current, skeleton, current->lastTime, time, alpha, int(m_fusedTracks.size()));
+        m_appliedTargets |= current->animation.targets;
+
+        FusedTrack track;
+        track.index = int(i);
+        track.entry = current;
+        track.time = time;
+        m_fusedTracks.push_back(track);
+    }
+
+    // Timelines which don't change bones only affect their own targets, so they can be applied entry by entry.
+    for (auto& e : m_fusedEntries)
+    {
+        if (e.frozen)
+        {
+            auto& frozen = *m_frozenPoses[e.frozenIndex];
+            frozen.pose.applySlotsAndConstraintsTo(skeleton, frozen.targets);
+            continue;
+        }
+
+        auto& timelines = e.animation->timelines;
+
+        std::vector<const Event*>* events = nullptr;
+        if (e.track >= 0)
+        {
+            m_fusedTracks[e.track].eventsBegin = m_events.size();
+            events = &m_events;
+        }
+
+        for (auto t : e.animation->m_otherTimelines)
+        {
+            if (!applyDeform && timelines[t]->getType() == Timeline::Type::Deform)
+            {
+                continue;
+            }
+
+            if (!e.mask)
+            {
+                timelines[t]->apply(skeleton, e.lastTime, e.time, events, e.alpha);
+            }
+            else if (float weight = e.mask->weights[t])
+            {
+                timelines[t]->apply(skeleton, e.lastTime, e.time, events, e.alpha * weight);
+            }
+        }
+
+        if (e.track >= 0)
+        {
+            m_fusedTracks[e.track].eventsEnd = m_events.size();
+        }
+    }
+
+    // The bone timelines of the entries are sorted by bone, so they're merged bone by bone. For each bone the
+    // timelines are applied in the same order as by apply to a copy of its local transform, which is then
+    // stored once.
+    for (;;)
+    {
+        int boneIndex = std::numeric_limits<int>::max();
+        for (auto& e : m_fusedEntries)
+        {
+            auto& boneTimelines = e.animation->m_boneTimelines;
+            if (e.cursor < boneTimelines.size())
+            {
+                boneIndex = std::min(boneIndex, boneTimelines[e.cursor].boneIndex);
             }
+        }
+
+        if (boneIndex == std::numeric_limits<int>::max()) break;
+
+        auto& bone = skeleton.bones[boneIndex];
+        auto pose = bone.getPose();
 
-            if (listener)
+        for (auto& e : m_fusedEntries)
+        {
+            auto& boneTimelines = e.animation->m_boneTimelines;
+            auto& timelines = e.animation->timelines;
+
+            if (e.frozen)
             {
-                listener(*this, int(i), EventType::Anim_Event, event, 0);
+                if (e.cursor < boneTimelines.size() && boneTimelines[e.cursor].boneIndex == boneIndex)
+                {
+                    applyFrozenBonePose(e.frozenIndex, *e.frozen, boneIndex, pose);
+                }
 
-                if (tracks[i] != current)
+                while (e.cursor < boneTimelines.size() && boneTimelines[e.cursor].boneIndex == boneIndex)
                 {
-                    // event changed current animation (tracks[i]), so stop processing it
-                    entryChanged = true;
-                    break;
+                    ++e.cursor;
                 }
+
+                continue;
+            }
+
+            while (e.cursor < boneTimelines.size() && boneTimelines[e.cursor].boneIndex == boneIndex)
+            {
+                int t = boneTimelines[e.cursor].timelineIndex;
+                if (!e.mask)
+                {
+                    timelines[t]->applyToBonePose(pose, bone.data, e.time, e.alpha, nullptr);
+                }
+                else if (float weight = e.mask->weights[t])
+                {
+                    timelines[t]->applyToBonePose(pose, bone.data, e.time, e.alpha * weight, nullptr);
+                }
+                ++e.cursor;
             }
         }
 
-        if (entryChanged)
+        bone.setPose(pose);
+    }
+
+    for (auto& e : m_fusedEntries)
+    {
+        e.animation->unlockTimelines();
+    }
+
+    for (auto entry : m_fusedDisposedEntries)
+    {
+        trackEntryFactory.destroyTrackEntry(entry);
+    }
+    m_fusedDisposedEntries.clear();
+
+    for (auto& track : m_fusedTracks)
+    {
+        if (track.index >= int(tracks.size()) || tracks[track.index] != track.entry)
         {
-            // event changed current animation (tracks[i]), so stop processing it
+            // a listener of a previous track changed the track
             continue;
         }
 
-        /* Check if completed the animation or a loop iteration. */
-        if (current->loop ?
-            (std::fmod(current->lastTime, current->endTime) > std::fmod(time, current->endTime))
-            : (current->lastTime < current->endTime && time >= current->endTime))
+        dispatchEvents(track.index, track.entry, track.time, track.eventsBegin, track.eventsEnd);
+    }
+}
+
+void AnimationState::recordAppliedTrack(int index, const TrackEntry& current, float time, const Skeleton& skeleton)
+{
+    if (index >= int(m_appliedTracks.size()))
+    {
+        // a listener added a track
+        m_appliedTracks.resize(index + 1);
+    }
+
+    auto& applied = m_appliedTracks[index];
+    applied.entry = &current;
+    applied.mix = current.mix;
+    applied.time = time;
+    applied.mixing = current.previous != nullptr;
+    applied.maskVersion = current.maskVersion;
+    applied.requiredBonesVersion = skeleton.getRequiredBonesVersion();
+    applied.applyDeform = applyDeform;
+}
+
+bool AnimationState::isPoseUnchanged(const Skeleton& skeleton) const
+{
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        auto current = tracks[i];
+
+        if (i >= m_appliedTracks.size())
+        {
+            if (current) return false;
+            continue;
+        }
+
+        auto& applied = m_appliedTracks[i];
+        if (applied.entry != current || applied.mixing) return false;
+
+        if (!current) continue;
+
+        if (current->previous || current->mix != applied.mix) return false;
+
+        if (current->maskVersion != applied.maskVersion || skeleton.getRequiredBonesVersion() != applied.requiredBonesVersion
+            || applyDeform != applied.applyDeform)
+        {
+            return false;
+        }
+
+        float time = current->time;
+        if (!current->loop && time > current->endTime)
+        {
+            time = current->endTime;
+        }
+
+        if (!isPoseSettled(*current, applied.time) || !isPoseSettled(*current, time)) return false;
+    }
+
+    // tracks applied last time which were removed
+    for (size_t i = tracks.size(); i < m_appliedTracks.size(); ++i)
+    {
+        if (m_appliedTracks[i].entry) return false;
+    }
+
+    return true;
+}
+
+void AnimationState::skipApply(Skeleton& skeleton)
+{
+    assert(isPoseUnchanged(skeleton));
+
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        auto current = tracks[i];
+        if (!current) continue;
+
+        m_events.clear();
+
+        float time = current->time;
+        if (!current->loop && time > current->endTime)
+        {
+            time = current->endTime;
+        }
+
+        recordAppliedTrack(int(i), *current, time, skeleton);
+        m_appliedTargets |= current->animation.targets;
+
+        collectEvents(skeleton, *current, time);
+        dispatchEvents(int(i), current, time, 0, m_events.size());
+    }
+}
+
+void AnimationState::applyEvents(Skeleton& skeleton)
+{
+    for (size_t i = 0; i < tracks.size(); ++i)
+    {
+        auto current = tracks[i];
+        if (!current) continue;
+
+        m_events.clear();
+
+        float time = current->time;
+        if (!current->loop && time > current->endTime)
         {
-            int count = (int)(time / current->endTime);
+            time = current->endTime;
+        }
+
+        if (current->previous && current->mixTime / current->mixDuration * current->mix >= 1)
+        {
+            trackEntryFactory.destroyTrackEntry(current->previous);
+            current->previous = nullptr;
+        }
+
+        collectEvents(skeleton, *current, time);
+        dispatchEvents(int(i), current, time, 0, m_events.size());
+    }
+}
+
+float AnimationState::getTimeToNextEvent() const
+{
+    float result = std::numeric_limits<float>::infinity();
+
+    for (auto current : tracks)
+    {
+        if (!current) continue;
 
-            if (current->listener)
+        if (current->next)
+        {
+            // the next entry starts on the update after the entry was applied at its delay
+            if (current->lastTime - current->next->delay >= 0 || current->time >= current->next->delay)
             {
-                current->listener(*this, int(i), EventType::Anim_Complete, nullptr, count);
-                if (tracks[i] != current)
-                {
-                    // event changed current animation (tracks[i]), so stop processing it
-                    continue;
-                }
+                return 0;
             }
 
-            if (listener)
+            result = std::min(result, getDeltaToTime(timeScale, *current, current->next->delay));
+        }
+
+        if (current->loop)
+        {
+            float endTime = current->endTime;
+            if (endTime > 0)
             {
-                listener(*this, int(i), EventType::Anim_Complete, nullptr, count);
+                float loopTime = std::fmod(current->time, endTime);
+                float delta = getDeltaToTime(timeScale, *current, current->time - loopTime + endTime);
 
-                if (tracks[i] != current)
+                // The completion is detected by the loop time getting smaller than on the last apply, which may not
+                // happen for a whole loop in one step from its very start. Stop in the middle of the loop first then.
+                float reachedTime = current->time + delta * timeScale * current->timeScale;
+                if (loopTime < endTime / 2 && loopTime <= std::fmod(reachedTime, endTime))
                 {
-                    // event changed current animation (tracks[i]), so stop processing it
-                    continue;
+                    delta = getDeltaToTime(timeScale, *current, current->time - loopTime + endTime / 2);
                 }
+
+                result = std::min(result, delta);
+            }
+        }
+        else if (current->time < current->endTime)
+        {
+            result = std::min(result, getDeltaToTime(timeScale, *current, current->endTime));
+        }
+        else if (current->lastTime < current->endTime || !current->next)
+        {
+            // the completion is pending or the track is cleared on the next update
+            return 0;
+        }
+
+        float eventTime = getNextEventKeyTime(*current, current->time);
+        if (eventTime < std::numeric_limits<float>::infinity())
+        {
+            result = std::min(result, getDeltaToTime(timeScale, *current, eventTime));
+        }
+    }
+
+    return result;
+}
+
+void AnimationState::catchUp(Skeleton& skeleton, float delta)
+{
+    while (true)
+    {
+        float step = std::min(getTimeToNextEvent(), delta);
+
+        update(step);
+        applyEvents(skeleton);
+
+        delta -= step;
+        if (delta <= 0) break;
+    }
+}
+
+void AnimationState::collectEvents(Skeleton& skeleton, const TrackEntry& current, float time)
+{
+    auto& animation = current.animation;
+    float lastTime = current.lastTime;
+    animation.getLoopTimes(lastTime, time, current.loop);
+
+    // Event timelines are never compressed, so they are in the timelines of animations in a cache too.
+    for (auto t : animation.timelines)
+    {
+        if (t->getType() == Timeline::Type::Event)
+        {
+            t->apply(skeleton, lastTime, time, &m_events, 1);
+        }
+    }
+}
+
+void AnimationState::addFusedEntry(TrackEntry& entry, const Skeleton& skeleton, float lastTime, float time, float alpha, int track)
+{
+    auto& animation = entry.animation;
+    animation.lockTimelines();
+    animation.getLoopTimes(lastTime, time, entry.loop);
+
+    FusedEntry e;
+    e.animation = &animation;
+    e.mask = getEntryMask(entry, skeleton);
+    e.lastTime = lastTime;
+    e.time = time;
+    e.alpha = alpha;
+    e.track = track;
+    e.cursor = 0;
+    e.frozen = nullptr;
+    e.frozenIndex = -1;
+    m_fusedEntries.push_back(e);
+}
+
+void AnimationState::freezePrevious(Skeleton& skeleton, int index, TrackEntry& current, float previousTime)
+{
+    if (index >= int(m_frozenPoses.size()))
+    {
+        m_frozenPoses.resize(index + 1);
+    }
+
+    auto& frozen = m_frozenPoses[index];
+    if (!frozen)
+    {
+        frozen.reset(new FrozenPose(data.skeletonData));
+    }
+
+    auto& animation = current.previous->animation;
+    int loop = current.previous->loop;
+
+    auto& pose = frozen->pose;
+    pose.skin = skeleton.getSkin();
+
+    // the pose a bit earlier is temporarily stored in the velocities
+    float dt = 0;
+    frozen->velocities.clear();
+    if (current.mixMode == MixMode::FrozenWithVelocity)
+    {
+        dt = std::min(FROZEN_VELOCITY_TIME_STEP, previousTime);
+        if (dt > 0)
+        {
+            pose.setToSetupPose();
+            animation.sampleInto(pose, previousTime - dt, loop);
+            frozen->velocities = pose.bones;
+        }
+    }
+
+    pose.setToSetupPose();
+    animation.sampleInto(pose, previousTime, loop);
+
+    for (size_t i = 0; i < frozen->velocities.size(); ++i)
+    {
+        auto& v = frozen->velocities[i];
+        auto& b = pose.bones[i];
+
+        v.translation = (b.translation - v.translation) * (1 / dt);
+
+        float rotation = b.rotation - v.rotation;
+        normalizeAngle(rotation);
+        v.rotation = rotation / dt;
+
+        v.scale = (b.scale - v.scale) * (1 / dt);
+        v.shear = (b.shear - v.shear) * (1 / dt);
+    }
+
+    auto& mask = current.previous->mask;
+
+    frozen->boneProperties.assign(pose.bones.size(), 0);
+    for (auto& bt : animation.m_boneTimelines)
+    {
+        if (!mask.empty() && mask.weights[bt.timelineIndex] == 0) continue;
+        frozen->boneProperties[bt.boneIndex] |= getBoneProperty(animation.timelines[bt.timelineIndex]->getType());
+    }
+
+    // masked timelines are captured fully if their weight isn't zero
+    frozen->targets.clear();
+    if (mask.empty())
+    {
+        frozen->targets |= animation.targets;
+    }
+    else
+    {
+        for (auto t : mask.timelines)
+        {
+            animation.timelines[t]->addTargets(frozen->targets);
+        }
+    }
+
+    current.previousFrozen = true;
+}
+
+void AnimationState::applyFrozenPose(Skeleton& skeleton, int index, const TrackEntry& current)
+{
+    auto& targets = m_frozenPoses[index]->targets;
+
+    targets.bones.forEach([this, &skeleton, index, &current](size_t i)
+    {
+        auto& bone = skeleton.bones[i];
+        auto pose = bone.getPose();
+        applyFrozenBonePose(index, current, int(i), pose);
+        bone.setPose(pose);
+    });
+
+    m_frozenPoses[index]->pose.applySlotsAndConstraintsTo(skeleton, targets);
+}
+
+void AnimationState::applyFrozenBonePose(int index, const TrackEntry& current, int boneIndex, BonePose& inOutPose) const
+{
+    auto& frozen = *m_frozenPoses[index];
+    auto& pose = frozen.pose.bones[boneIndex];
+    int properties = frozen.boneProperties[boneIndex];
+
+    // The velocity decays linearly to zero by the end of the mix, so the bone moves by its integral.
+    float offset = 0;
+    const BonePose* velocity = nullptr;
+    if (!frozen.velocities.empty())
+    {
+        float t = std::min(current.mixTime, current.mixDuration);
+        offset = t - t * t / (2 * current.mixDuration);
+        velocity = &frozen.velocities[boneIndex];
+    }
+
+    if (properties & Bone_Translation)
+    {
+        inOutPose.translation = pose.translation;
+        if (velocity) inOutPose.translation += velocity->translation * offset;
+    }
+
+    if (properties & Bone_Rotation)
+    {
+        inOutPose.rotation = pose.rotation;
+        if (velocity) inOutPose.rotation += velocity->rotation * offset;
+    }
+
+    if (properties & Bone_Scale)
+    {
+        inOutPose.scale = pose.scale;
+        if (velocity) inOutPose.scale += velocity->scale * offset;
+    }
+
+    if (properties & Bone_Shear)
+    {
+        inOutPose.shear = pose.shear;
+        if (velocity) inOutPose.shear += velocity->shear * offset;
+    }
+}
+
+void AnimationState::dispatchEvents(int index, TrackEntry* current, float time, size_t eventsBegin, size_t eventsEnd)
+{
+    for (size_t e = eventsBegin; e < eventsEnd; ++e)
+    {
+        auto event = m_events[e];
+
+        if (current->listener)
+        {
+            current->listener(*this, index, EventType::Anim_Event, event, 0);
+
+            if (tracks[index] != current)
+            {
+                // event changed current animation (tracks[index]), so stop processing it
+                return;
             }
         }
 
-        current->lastTime = current->time;
+        if (listener)
+        {
+            listener(*this, index, EventType::Anim_Event, event, 0);
+
+            if (tracks[index] != current)
+            {
+                // event changed current animation (tracks[index]), so stop processing it
+                return;
+            }
+        }
     }
+
+    /* Check if completed the animation or a loop iteration. */
+    if (current->loop ?
+        (std::fmod(current->lastTime, current->endTime) > std::fmod(time, current->endTime))
+        : (current->lastTime < current->endTime && time >= current->endTime))
+    {
+        int count = (int)(time / current->endTime);
+
+        if (current->listener)
+        {
+            current->listener(*this, index, EventType::Anim_Complete, nullptr, count);
+            if (tracks[index] != current)
+            {
+                // event changed current animation (tracks[index]), so stop processing it
+                return;
+            }
+        }
+
+        if (listener)
+        {
+            listener(*this, index, EventType::Anim_Complete, nullptr, count);
+
+            if (tracks[index] != current)
+            {
+                // event changed current animation (tracks[index]), so stop processing it
+                return;
+            }
+        }
+    }
+
+    current->lastTime = current->time;
+}
+
+void AnimationState::setTargetsToSetupPose(Skeleton& skeleton)
+{
+    m_resetTargets.clear();
+    m_resetTargets |= m_appliedTargets;
+
+    for (auto current : tracks)
+    {
+        if (!current) continue;
+
+        m_resetTargets |= current->animation.targets;
+        if (current->previous)
+        {
+            m_resetTargets |= current->previous->animation.targets;
+        }
+    }
+
+    skeleton.setToSetupPose(m_resetTargets);
+
+    m_appliedTargets.clear();
 }
 
 void AnimationState::clearTracks()
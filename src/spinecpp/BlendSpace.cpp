@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/BlendSpace.h>
+#include <spinecpp/SkeletonData.h>
+#include <spinecpp/Skeleton.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace spine
+{
+
+BlendSpace::BlendSpace(const SkeletonData& data)
+    : m_pose(data)
+{
+}
+
+int BlendSpace::addClip(const Animation& animation, float x, float y, bool loop)
+{
+    Clip clip;
+    clip.animation = &animation;
+    clip.position = Vector(x, y);
+    clip.loop = loop;
+    clip.time = 0;
+    clip.weight = 0;
+    m_clips.push_back(clip);
+
+    m_activeClips.reserve(m_clips.size());
+    m_targets |= animation.targets;
+
+    return int(m_clips.size() - 1);
+}
+
+void BlendSpace::setPhase(float phase)
+{
+    m_phase = phase;
+    for (auto& clip : m_clips)
+    {
+        if (clip.loop)
+        {
+            clip.time = m_phase * clip.animation->duration;
+        }
+    }
+}
+
+void BlendSpace::updateWeights()
+{
+    // Gradient band interpolation: the weight of a clip falls off linearly towards each other clip, along the
+    // line between them, and the smallest of these falloffs is used.
+    float total = 0;
+    for (size_t i = 0; i < m_clips.size(); ++i)
+    {
+        auto& clip = m_clips[i];
+        auto toParameter = parameter - clip.position;
+
+        float weight = 1;
+        for (size_t j = 0; j < m_clips.size(); ++j)
+        {
+            if (j == i) continue;
+
+            auto toOther = m_clips[j].position - clip.position;
+            float lengthSquared = toOther.x * toOther.x + toOther.y * toOther.y;
+            if (lengthSquared == 0) continue;
+
+            float falloff = 1 - (toParameter.x * toOther.x + toParameter.y * toOther.y) / lengthSquared;
+            weight = std::min(weight, std::max(falloff, 0.f));
+        }
+
+        clip.weight = weight;
+        total += weight;
+    }
+
+    // skip the negligible clips and renormalize the rest
+    float prunedTotal = 0;
+    for (auto& clip : m_clips)
+    {
+        if (clip.weight < minWeight * total)
+        {
+            clip.weight = 0;
+        }
+        prunedTotal += clip.weight;
+    }
+
+    m_activeClips.clear();
+
+    if (prunedTotal == 0)
+    {
+        if (m_clips.empty()) return;
+
+        // no clip has a weight (duplicate positions), so use the closest one
+        int closest = 0;
+        float closestDistance = (m_clips[0].position - parameter).length();
+        for (size_t i = 1; i < m_clips.size(); ++i)
+        {
+            float distance = (m_clips[i].position - parameter).length();
+            if (distance < closestDistance)
+            {
+                closest = int(i);
+                closestDistance = distance;
+            }
+        }
+
+        m_clips[closest].weight = prunedTotal = 1;
+    }
+
+    for (size_t i = 0; i < m_clips.size(); ++i)
+    {
+        auto& clip = m_clips[i];
+        if (clip.weight > 0)
+        {
+            clip.weight /= prunedTotal;
+            m_activeClips.push_back(int(i));
+        }
+    }
+
+    // The heaviest clip is applied last, so it decides the values which aren't mixed (like attachments).
+    std::sort(m_activeClips.begin(), m_activeClips.end(), [this](int a, int b)
+    {
+        return m_clips[a].weight < m_clips[b].weight;
+    });
+}
+
+void BlendSpace::update(float delta)
+{
+    updateWeights();
+
+    delta *= timeScale;
+
+    // the synchronized clips advance with the weighted average of their durations
+    float duration = 0;
+    float loopWeight = 0;
+    for (auto i : m_activeClips)
+    {
+        auto& clip = m_clips[i];
+        if (clip.loop)
+        {
+            duration += clip.weight * clip.animation->duration;
+            loopWeight += clip.weight;
+        }
+    }
+
+    if (duration > 0)
+    {
+        duration /= loopWeight;
+        m_phase = std::fmod(m_phase + delta / duration, 1.f);
+        if (m_phase < 0)
+        {
+            m_phase += 1;
+        }
+    }
+
+    for (auto& clip : m_clips)
+    {
+        if (clip.loop)
+        {
+            clip.time = m_phase * clip.animation->duration;
+        }
+        else
+        {
+            clip.time = std::min(clip.time + delta, clip.animation->duration);
+        }
+    }
+}
+
+void BlendSpace::evaluate(const Skin* skin)
+{
+    m_pose.skin = skin;
+    m_pose.setToSetupPose();
+
+    // Each clip is mixed into the blend of the previous ones with its share of their total weight, which
+    // results in the weighted average of all of them.
+    float total = 0;
+    for (auto i : m_activeClips)
+    {
+        auto& clip = m_clips[i];
+        total += clip.weight;
+        clip.animation->mixInto(m_pose, clip.time, clip.loop, clip.weight / total);
+    }
+}
+
+void BlendSpace::apply(Skeleton& skeleton)
+{
+    evaluate(skeleton.getSkin());
+
+    m_targets.bones.forEach([this, &skeleton](size_t i)
+    {
+        skeleton.bones[i].setPose(m_pose.bones[i]);
+    });
+
+    m_pose.applySlotsAndConstraintsTo(skeleton, m_targets);
+}
+
+}
@@ -32,22 +32,19 @@
 #include <spinecpp/Bone.h>
 #include <spinecpp/Skeleton.h>
 #include <spinecpp/extension.h>
+#include <spinecpp/Trig.h>
 
 #include <cmath>
+#include <cassert>
 
 using namespace std;
 
 namespace
 {
 
-inline float sin_deg(float f)
+inline void sincos_deg(float f, float& outSin, float& outCos)
 {
-    return sin(f * DEG_RAD);
-}
-
-inline float cos_deg(float f)
-{
-    return cos(f * DEG_RAD);
+    spine::trig::sincos(f * DEG_RAD, outSin, outCos);
 }
 
 }
@@ -83,20 +80,84 @@ void Bone::setToSetupPose()
     shear = data.shear;
 }
 
+BonePose Bone::getPose() const
+{
+    BonePose pose;
+    pose.translation = translation;
+    pose.rotation = rotation;
+    pose.scale = scale;
+    pose.shear = shear;
+    return pose;
+}
+
+void Bone::setPose(const BonePose& pose)
+{
+    translation = pose.translation;
+    rotation = pose.rotation;
+    scale = pose.scale;
+    shear = pose.shear;
+}
+
+BoneInheritance Bone::getInheritance() const
+{
+    if (!parent) return BoneInheritance::Root;
+
+    if (data.inheritRotation)
+    {
+        return data.inheritScale ? BoneInheritance::Full : BoneInheritance::NoScale;
+    }
+
+    return data.inheritScale ? BoneInheritance::NoRotation : BoneInheritance::None;
+}
+
 void Bone::updateWorldTransform()
 {
     updateWorldTransformWith(translation, rotation, scale, shear);
 }
 
+template <BoneInheritance Inheritance>
+void Bone::updateWorldTransformAs()
+{
+    assert(getInheritance() == Inheritance);
+    updateWorldTransformWithAs<Inheritance>(translation, rotation, scale, shear);
+}
+
 void Bone::updateWorldTransformWith(Vector translation, float rotation, Vector scale, Vector shear)
+{
+    switch (getInheritance())
+    {
+    case BoneInheritance::Root:
+        updateWorldTransformWithAs<BoneInheritance::Root>(translation, rotation, scale, shear);
+        break;
+    case BoneInheritance::Full:
+        updateWorldTransformWithAs<BoneInheritance::Full>(translation, rotation, scale, shear);
+        break;
+    case BoneInheritance::NoScale:
+        updateWorldTransformWithAs<BoneInheritance::NoScale>(translation, rotation, scale, shear);
+        break;
+    case BoneInheritance::NoRotation:
+        updateWorldTransformWithAs<BoneInheritance::NoRotation>(translation, rotation, scale, shear);
+        break;
+    case BoneInheritance::None:
+        updateWorldTransformWithAs<BoneInheritance::None>(translation, rotation, scale, shear);
+        break;
+    }
+}
+
+// The checks of Inheritance are resolved at compile time
+template <BoneInheritance Inheritance>
+void Bone::updateWorldTransformWithAs(Vector translation, float rotation, Vector scale, Vector shear)
 {
     appliedRotation = rotation;
 
     float rotationY = rotation + 90 + shear.y;
-    float la = cos_deg(rotation + shear.x) * scale.x, lb = cos_deg(rotationY) * scale.y;
-    float lc = sin_deg(rotation + shear.x) * scale.x, ld = sin_deg(rotationY) * scale.y;
+    float sineX, cosineX, sineY, cosineY;
+    sincos_deg(rotation + shear.x, sineX, cosineX);
+    sincos_deg(rotationY, sineY, cosineY);
+    float la = cosineX * scale.x, lb = cosineY * scale.y;
+    float lc = sineX * scale.x, ld = sineY * scale.y;
 
-    if (!parent) // Root bone.
+    if (Inheritance == BoneInheritance::Root)
     {
         if (skeleton.flipX)
         {
@@ -134,7 +195,7 @@ void Bone::updateWorldTransformWith(Vector translation, float rotation, Vector s
     worldSign.x = parent->worldSign.x * (scale.x > 0 ? 1.f : -1.f);
     worldSign.y = parent->worldSign.y * (scale.y > 0 ? 1.f : -1.f);
 
-    if (data.inheritRotation && data.inheritScale)
+    if (Inheritance == BoneInheritance::Full)
     {
         a = pa * la + pb * lc;
         b = pa * lb + pb * ld;
@@ -143,7 +204,7 @@ void Bone::updateWorldTransformWith(Vector translation, float rotation, Vector s
     }
     else 
     {
-        if (data.inheritRotation) /* No scale inheritance. */
+        if (Inheritance == BoneInheritance::NoScale)
         {
             pa = 1;
             pb = 0;
@@ -154,8 +215,8 @@ void Bone::updateWorldTransformWith(Vector translation, float rotation, Vector s
 
             do
             {
-                float cosine = cos_deg(p->appliedRotation); 
-                float sine = sin_deg(p->appliedRotation);
+                float sine, cosine;
+                sincos_deg(p->appliedRotation, sine, cosine);
                 float temp = pa * cosine + pb * sine;
                 pb = pb * cosine - pa * sine;
                 pa = temp;
@@ -172,7 +233,7 @@ void Bone::updateWorldTransformWith(Vector translation, float rotation, Vector s
             c = pc * la + pd * lc;
             d = pc * lb + pd * ld;
         }
-        else if (data.inheritScale) /* No rotation inheritance. */
+        else if (Inheritance == BoneInheritance::NoRotation)
         {
             pa = 1;
             pb = 0;
@@ -185,8 +246,8 @@ void Bone::updateWorldTransformWith(Vector translation, float rotation, Vector s
                 float za, zb, zc, zd;
 
                 float psx = p->scale.x, psy = p->scale.y;
-                float cosine = cos_deg(p->appliedRotation);
-                float sine = sin_deg(p->appliedRotation);
+                float sine, cosine;
+                sincos_deg(p->appliedRotation, sine, cosine);
                 za = cosine * psx; zb = sine * psy; zc = sine * psx; zd = cosine * psy;
                 float temp = pa * za + pb * zc;
                 pb = pb * zd - pa * zb;
@@ -235,14 +296,20 @@ void Bone::updateWorldTransformWith(Vector translation, float rotation, Vector s
     }
 }
 
+template void Bone::updateWorldTransformAs<BoneInheritance::Root>();
+template void Bone::updateWorldTransformAs<BoneInheritance::Full>();
+template void Bone::updateWorldTransformAs<BoneInheritance::NoScale>();
+template void Bone::updateWorldTransformAs<BoneInheritance::NoRotation>();
+template void Bone::updateWorldTransformAs<BoneInheritance::None>();
+
 float Bone::getWorldRotationX() const
 {
-    return atan2(c, a) * RAD_DEG;
+    return trig::atan2(c, a) * RAD_DEG;
 }
 
 float Bone::getWorldRotationY() const
 {
-    return atan2(d, b) * RAD_DEG;
+    return trig::atan2(d, b) * RAD_DEG;
 }
 
 float Bone::getWorldScaleX() const
@@ -258,18 +325,19 @@ float Bone::getWorldScaleY() const
 float Bone::worldToLocalRotationX() const
 {
     if (!parent) return rotation;
-    return atan2(parent->a * c - parent->c * a, parent->d * a - parent->b * c) * RAD_DEG;
+    return trig::atan2(parent->a * c - parent->c * a, parent->d * a - parent->b * c) * RAD_DEG;
 }
 
 float Bone::worldToLocalRotationY() const
 {
     if (!parent) return rotation;
-    return atan2(parent->a * d - parent->c * b, parent->d * b - parent->b * d) * RAD_DEG;
+    return trig::atan2(parent->a * d - parent->c * b, parent->d * b - parent->b * d) * RAD_DEG;
 }
 
 void Bone::rotateWorld(float degrees)
 {
-    float cosine = cos_deg(degrees), sine = sin_deg(degrees);
+    float sine, cosine;
+    sincos_deg(degrees, sine, cosine);
 
     float a = this->a, b = this->b, c = this->c, d = this->d;
 
@@ -290,11 +358,11 @@ void Bone::updateLocalTransform()
     {
         float det = a * d - b * c;
         translation = worldPos;
-        rotation = atan2(c, a) * RAD_DEG;
+        rotation = trig::atan2(c, a) * RAD_DEG;
         scale.x = sqrt(a * a + c * c);
         scale.y = sqrt(b * b + d * d);
         shear.x = 0;
-        shear.y = atan2(a * b + c * d, det) * RAD_DEG;
+        shear.y = trig::atan2(a * b + c * d, det) * RAD_DEG;
     }
     else {
         float pa = parent->a, pb = parent->b, pc = parent->c, pd = parent->d;
@@ -316,15 +384,15 @@ void Bone::updateLocalTransform()
         {
             float det = ra * rd - rb * rc;
             scale.y = det / scale.x;
-            shear.y = atan2(ra * rb + rc * rd, det) * RAD_DEG;
-            rotation = atan2(rc, ra) * RAD_DEG;
+            shear.y = trig::atan2(ra * rb + rc * rd, det) * RAD_DEG;
+            rotation = trig::atan2(rc, ra) * RAD_DEG;
         }
         else
         {
             scale.x = 0;
             scale.y = sqrt(rb * rb + rd * rd);
             shear.y = 0;
-            rotation = 90 - atan2(rd, rb) * RAD_DEG;
+            rotation = 90 - trig::atan2(rd, rb) * RAD_DEG;
         }
         appliedRotation = rotation;
     }
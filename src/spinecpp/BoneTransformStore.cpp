@@ -0,0 +1,397 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/BoneTransformStore.h>
+#include <spinecpp/Bone.h>
+#include <spinecpp/Trig.h>
+#include <spinecpp/extension.h>
+
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define SPINECPP_TRANSFORM_SSE 1
+#   include <emmintrin.h>
+#endif
+
+namespace
+{
+
+#if defined(SPINECPP_TRANSFORM_SSE)
+
+// Sine and cosine of 4 angles in radians with the polynomials of the Cephes library (trig::SinCoefficients and
+// trig::CosCoefficients). The error is within a couple of
+// ulps of std::sin and std::cos for angles up to thousands of radians.
+inline void sincos4(__m128 x, __m128& outSin, __m128& outCos)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(int(0x80000000)));
+
+    __m128 sinSign = _mm_and_ps(x, signMask);
+    x = _mm_andnot_ps(signMask, x);
+
+    // the octant of the angle, rounded to even
+    __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f))); // 4 / PI
+    j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128 y = _mm_cvtepi32_ps(j);
+
+    sinSign = _mm_xor_ps(sinSign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+
+    // in the octants where this is false the sine and cosine polynomials are swapped
+    __m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+    // x - y * PI / 4 in extended precision
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+
+    __m128 z = _mm_mul_ps(x, x);
+
+    __m128 c = _mm_set1_ps(spine::trig::CosCoefficients[0]);
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(spine::trig::CosCoefficients[1]));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(spine::trig::CosCoefficients[2]));
+    c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+    c = _mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    c = _mm_add_ps(c, _mm_set1_ps(1));
+
+    __m128 s = _mm_set1_ps(spine::trig::SinCoefficients[0]);
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(spine::trig::SinCoefficients[1]));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(spine::trig::SinCoefficients[2]));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), x), x);
+
+    outSin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(polyMask, s), _mm_andnot_ps(polyMask, c)), sinSign);
+    outCos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(polyMask, c), _mm_andnot_ps(polyMask, s)), cosSign);
+}
+
+// world transforms of four bones, one per lane
+struct World4
+{
+    __m128 a, b, c, d;
+    __m128 x, y;
+    __m128 signX, signY;
+};
+
+// Calculates the world transforms of four bones which inherit rotation and scale from the local transforms of the
+// bones and the world transforms of their parents, like Bone::updateWorldTransform. Shared by the kernel of the store
+// and BoneTransformStore::updateBones, which only differ in where they read the parents from.
+inline World4 updateWorld4(const spine::Bone* const* bones, const World4& parent)
+{
+    auto b0 = bones[0], b1 = bones[1], b2 = bones[2], b3 = bones[3];
+
+    __m128 rotation = _mm_setr_ps(b0->rotation, b1->rotation, b2->rotation, b3->rotation);
+    __m128 scaleX = _mm_setr_ps(b0->scale.x, b1->scale.x, b2->scale.x, b3->scale.x);
+    __m128 scaleY = _mm_setr_ps(b0->scale.y, b1->scale.y, b2->scale.y, b3->scale.y);
+    __m128 shearX = _mm_setr_ps(b0->shear.x, b1->shear.x, b2->shear.x, b3->shear.x);
+    __m128 shearY = _mm_setr_ps(b0->shear.y, b1->shear.y, b2->shear.y, b3->shear.y);
+    __m128 x = _mm_setr_ps(b0->translation.x, b1->translation.x, b2->translation.x, b3->translation.x);
+    __m128 y = _mm_setr_ps(b0->translation.y, b1->translation.y, b2->translation.y, b3->translation.y);
+
+    const __m128 degRad = _mm_set1_ps(DEG_RAD);
+    __m128 sinX, cosX, sinY, cosY;
+    sincos4(_mm_mul_ps(_mm_add_ps(rotation, shearX), degRad), sinX, cosX);
+    sincos4(_mm_mul_ps(_mm_add_ps(_mm_add_ps(rotation, _mm_set1_ps(90)), shearY), degRad), sinY, cosY);
+
+    __m128 la = _mm_mul_ps(cosX, scaleX), lb = _mm_mul_ps(cosY, scaleY);
+    __m128 lc = _mm_mul_ps(sinX, scaleX), ld = _mm_mul_ps(sinY, scaleY);
+
+    World4 world;
+    world.a = _mm_add_ps(_mm_mul_ps(parent.a, la), _mm_mul_ps(parent.b, lc));
+    world.b = _mm_add_ps(_mm_mul_ps(parent.a, lb), _mm_mul_ps(parent.b, ld));
+    world.c = _mm_add_ps(_mm_mul_ps(parent.c, la), _mm_mul_ps(parent.d, lc));
+    world.d = _mm_add_ps(_mm_mul_ps(parent.c, lb), _mm_mul_ps(parent.d, ld));
+    world.x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(parent.a, x), _mm_mul_ps(parent.b, y)), parent.x);
+    world.y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(parent.c, x), _mm_mul_ps(parent.d, y)), parent.y);
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1);
+    const __m128 minusOne = _mm_set1_ps(-1);
+    __m128 positiveX = _mm_cmpgt_ps(scaleX, zero);
+    __m128 positiveY = _mm_cmpgt_ps(scaleY, zero);
+    world.signX = _mm_mul_ps(parent.signX, _mm_or_ps(_mm_and_ps(positiveX, one), _mm_andnot_ps(positiveX, minusOne)));
+    world.signY = _mm_mul_ps(parent.signY, _mm_or_ps(_mm_and_ps(positiveY, one), _mm_andnot_ps(positiveY, minusOne)));
+
+    return world;
+}
+
+// writes the world transforms of four bones to them
+inline void writeWorld4(const World4& world, spine::Bone* const* bones)
+{
+    float a[4], b[4], c[4], d[4], x[4], y[4], signX[4], signY[4];
+    _mm_storeu_ps(a, world.a);
+    _mm_storeu_ps(b, world.b);
+    _mm_storeu_ps(c, world.c);
+    _mm_storeu_ps(d, world.d);
+    _mm_storeu_ps(x, world.x);
+    _mm_storeu_ps(y, world.y);
+    _mm_storeu_ps(signX, world.signX);
+    _mm_storeu_ps(signY, world.signY);
+
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+        auto bone = bones[lane];
+        bone->appliedRotation = bone->rotation;
+        bone->a = a[lane];
+        bone->b = b[lane];
+        bone->c = c[lane];
+        bone->d = d[lane];
+        bone->worldPos.x = x[lane];
+        bone->worldPos.y = y[lane];
+        bone->worldSign.x = signX[lane];
+        bone->worldSign.y = signY[lane];
+    }
+}
+
+#endif
+
+const size_t NoParent = std::numeric_limits<size_t>::max();
+
+inline bool isKernelBone(const spine::Bone& bone)
+{
+    return bone.parent && bone.data.inheritRotation && bone.data.inheritScale;
+}
+
+}
+
+namespace spine
+{
+
+void BoneTransformStore::clear()
+{
+    m_runs.clear();
+    m_groups.clear();
+    m_bones.clear();
+    m_parents.clear();
+}
+
+size_t BoneTransformStore::addRun(const std::vector<Bone*>& bones)
+{
+    Run run;
+
+    // depths within the run and the parents which aren't in it
+    std::unordered_map<const Bone*, int> depths;
+    std::vector<Bone*> imports;
+    int maxDepth = 0;
+    for (auto bone : bones)
+    {
+        int depth = 0;
+        if (bone->parent)
+        {
+            auto parentDepth = depths.find(bone->parent);
+            if (parentDepth != depths.end())
+            {
+                depth = parentDepth->second + 1;
+            }
+            else if (std::find(imports.begin(), imports.end(), bone->parent) == imports.end())
+            {
+                imports.push_back(bone->parent);
+            }
+        }
+
+        depths[bone] = depth;
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    std::unordered_map<const Bone*, size_t> slots;
+
+    run.importsBegin = m_bones.size();
+    for (auto bone : imports)
+    {
+        slots[bone] = m_bones.size();
+        m_bones.push_back(bone);
+    }
+    run.importsEnd = m_bones.size();
+
+    run.groupsBegin = m_groups.size();
+    for (int depth = 0; depth <= maxDepth; ++depth)
+    {
+        Group group;
+        group.begin = m_bones.size();
+
+        for (int kernel = 1; kernel >= 0; --kernel)
+        {
+            for (auto bone : bones)
+            {
+                if (depths[bone] != depth || isKernelBone(*bone) != !!kernel) continue;
+
+                slots[bone] = m_bones.size();
+                m_bones.push_back(bone);
+            }
+
+            if (kernel)
+            {
+                group.kernelEnd = m_bones.size();
+            }
+        }
+
+        group.end = m_bones.size();
+        m_groups.push_back(group);
+    }
+    run.groupsEnd = m_groups.size();
+
+    m_parents.resize(m_bones.size(), NoParent);
+    for (size_t i = run.importsEnd; i < m_bones.size(); ++i)
+    {
+        if (isKernelBone(*m_bones[i]))
+        {
+            m_parents[i] = slots[m_bones[i]->parent];
+        }
+    }
+
+    size_t numSlots = m_bones.size();
+    for (auto v : { &m_a, &m_b, &m_c, &m_d, &m_worldX, &m_worldY, &m_signX, &m_signY })
+    {
+        v->resize(numSlots);
+    }
+
+    m_runs.push_back(run);
+    return m_runs.size() - 1;
+}
+
+void BoneTransformStore::updateRun(size_t index)
+{
+    auto& run = m_runs[index];
+
+    for (size_t i = run.importsBegin; i < run.importsEnd; ++i)
+    {
+        importWorld(i);
+    }
+
+    for (size_t g = run.groupsBegin; g < run.groupsEnd; ++g)
+    {
+        auto& group = m_groups[g];
+
+        updateKernel(group.begin, group.kernelEnd);
+
+        for (size_t i = group.kernelEnd; i < group.end; ++i)
+        {
+            m_bones[i]->updateWorldTransform();
+            importWorld(i);
+        }
+    }
+}
+
+void BoneTransformStore::importWorld(size_t slot)
+{
+    auto bone = m_bones[slot];
+    m_a[slot] = bone->a;
+    m_b[slot] = bone->b;
+    m_c[slot] = bone->c;
+    m_d[slot] = bone->d;
+    m_worldX[slot] = bone->worldPos.x;
+    m_worldY[slot] = bone->worldPos.y;
+    m_signX[slot] = bone->worldSign.x;
+    m_signY[slot] = bone->worldSign.y;
+}
+
+void BoneTransformStore::updateKernel(size_t begin, size_t end)
+{
+    size_t slot = begin;
+
+#if defined(SPINECPP_TRANSFORM_SSE)
+    auto bones = m_bones.data();
+    auto parents = m_parents.data();
+    float* a = m_a.data();
+    float* b = m_b.data();
+    float* c = m_c.data();
+    float* d = m_d.data();
+    float* worldX = m_worldX.data();
+    float* worldY = m_worldY.data();
+    float* signX = m_signX.data();
+    float* signY = m_signY.data();
+
+    for (; slot + 4 <= end; slot += 4)
+    {
+        size_t p0 = parents[slot], p1 = parents[slot + 1], p2 = parents[slot + 2], p3 = parents[slot + 3];
+
+        World4 parent;
+        parent.a = _mm_setr_ps(a[p0], a[p1], a[p2], a[p3]);
+        parent.b = _mm_setr_ps(b[p0], b[p1], b[p2], b[p3]);
+        parent.c = _mm_setr_ps(c[p0], c[p1], c[p2], c[p3]);
+        parent.d = _mm_setr_ps(d[p0], d[p1], d[p2], d[p3]);
+        parent.x = _mm_setr_ps(worldX[p0], worldX[p1], worldX[p2], worldX[p3]);
+        parent.y = _mm_setr_ps(worldY[p0], worldY[p1], worldY[p2], worldY[p3]);
+        parent.signX = _mm_setr_ps(signX[p0], signX[p1], signX[p2], signX[p3]);
+        parent.signY = _mm_setr_ps(signY[p0], signY[p1], signY[p2], signY[p3]);
+
+        World4 world = updateWorld4(bones + slot, parent);
+
+        _mm_storeu_ps(a + slot, world.a);
+        _mm_storeu_ps(b + slot, world.b);
+        _mm_storeu_ps(c + slot, world.c);
+        _mm_storeu_ps(d + slot, world.d);
+        _mm_storeu_ps(worldX + slot, world.x);
+        _mm_storeu_ps(worldY + slot, world.y);
+        _mm_storeu_ps(signX + slot, world.signX);
+        _mm_storeu_ps(signY + slot, world.signY);
+
+        // write the results back while the bones are in the cache
+        writeWorld4(world, bones + slot);
+    }
+#endif
+
+    for (; slot < end; ++slot)
+    {
+        m_bones[slot]->updateWorldTransform();
+        importWorld(slot);
+    }
+}
+
+void BoneTransformStore::updateBones(Bone* const* bones, size_t count)
+{
+    size_t i = 0;
+
+#if defined(SPINECPP_TRANSFORM_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        auto p0 = bones[i]->parent, p1 = bones[i + 1]->parent, p2 = bones[i + 2]->parent, p3 = bones[i + 3]->parent;
+
+        World4 parent;
+        parent.a = _mm_setr_ps(p0->a, p1->a, p2->a, p3->a);
+        parent.b = _mm_setr_ps(p0->b, p1->b, p2->b, p3->b);
+        parent.c = _mm_setr_ps(p0->c, p1->c, p2->c, p3->c);
+        parent.d = _mm_setr_ps(p0->d, p1->d, p2->d, p3->d);
+        parent.x = _mm_setr_ps(p0->worldPos.x, p1->worldPos.x, p2->worldPos.x, p3->worldPos.x);
+        parent.y = _mm_setr_ps(p0->worldPos.y, p1->worldPos.y, p2->worldPos.y, p3->worldPos.y);
+        parent.signX = _mm_setr_ps(p0->worldSign.x, p1->worldSign.x, p2->worldSign.x, p3->worldSign.x);
+        parent.signY = _mm_setr_ps(p0->worldSign.y, p1->worldSign.y, p2->worldSign.y, p3->worldSign.y);
+
+        writeWorld4(updateWorld4(bones + i, parent), bones + i);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        bones[i]->updateWorldTransform();
+    }
+}
+
+}
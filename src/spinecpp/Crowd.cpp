@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/Crowd.h>
+#include <spinecpp/SkeletonData.h>
+#include <spinecpp/Skeleton.h>
+#include <spinecpp/RegionAttachment.h>
+#include <spinecpp/VertexAttachment.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace spine
+{
+
+void CrowdInstance::computeWorldVertices(const Slot& slot, const RegionAttachment& attachment, float* outVertices) const
+{
+    assert(&slot.bone.skeleton == pose);
+    attachment.computeWorldVertices(slot.bone, translation, outVertices);
+}
+
+void CrowdInstance::computeWorldVertices(const Slot& slot, const VertexAttachment& attachment, float* outWorldVertices) const
+{
+    assert(&slot.bone.skeleton == pose);
+    attachment.computeWorldVertices(slot, translation, outWorldVertices);
+}
+
+Color CrowdInstance::getSlotColor(const Slot& slot, const Color& attachmentColor) const
+{
+    auto& skeletonColor = slot.bone.skeleton.color;
+    return Color(
+        color.r * skeletonColor.r * slot.color.r * attachmentColor.r,
+        color.g * skeletonColor.g * slot.color.g * attachmentColor.g,
+        color.b * skeletonColor.b * slot.color.b * attachmentColor.b,
+        color.a * skeletonColor.a * slot.color.a * attachmentColor.a);
+}
+
+Crowd::Crowd(const SkeletonData& data, float timeStep, const Skin* skin)
+    : data(data)
+    , timeStep(timeStep)
+    , m_skin(skin)
+{
+    assert(timeStep > 0);
+}
+
+Crowd::~Crowd()
+{
+}
+
+void Crowd::update(CrowdInstance* instances, size_t count)
+{
+    beginUpdate();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& instance = instances[i];
+        instance.pose = instance.animation ? &getPose(*instance.animation, instance.time, instance.loop) : nullptr;
+    }
+}
+
+const Skeleton& Crowd::getPose(const Animation& animation, float time, int loop)
+{
+    assert(&data.animations.front() <= &animation && &animation <= &data.animations.back());
+
+    if (loop && animation.duration)
+    {
+        time = std::fmod(time, animation.duration);
+    }
+    else
+    {
+        time = std::min(time, animation.duration);
+    }
+
+    int step = std::max(int(std::floor(time / timeStep + 0.5f)), 0);
+
+    if (loop && animation.duration)
+    {
+        // a time just before the end rounds to the step at the duration, which is the pose of step 0
+        int numSteps = std::max(int(std::floor(animation.duration / timeStep + 0.5f)), 1);
+        step %= numSteps;
+    }
+
+    uint64_t key = uint64_t(&animation - data.animations.data()) << 32 | uint32_t(step);
+
+    auto found = m_poseIndices.find(key);
+    if (found != m_poseIndices.end())
+    {
+        auto& pose = m_poses[found->second];
+        pose.lastUpdate = m_update;
+        return *pose.skeleton;
+    }
+
+    auto& pose = allocatePose(key);
+    auto& skeleton = *pose.skeleton;
+
+    float stepTime = std::min(step * timeStep, animation.duration);
+
+    skeleton.setToSetupPose();
+    animation.apply(skeleton, stepTime, stepTime, false, nullptr);
+    skeleton.updateWorldTransform();
+
+    ++m_evaluations;
+
+    return skeleton;
+}
+
+Crowd::SharedPose& Crowd::allocatePose(uint64_t key)
+{
+    size_t index = m_poses.size();
+
+    if (m_poses.size() >= maxPoses)
+    {
+        // reuse the least recently used pose which isn't used in this update
+        for (size_t i = 0; i < m_poses.size(); ++i)
+        {
+            auto& pose = m_poses[i];
+            if (pose.lastUpdate != m_update && (index == m_poses.size() || pose.lastUpdate < m_poses[index].lastUpdate))
+            {
+                index = i;
+            }
+        }
+    }
+
+    if (index == m_poses.size())
+    {
+        SharedPose pose;
+        pose.skeleton.reset(new Skeleton(data));
+        pose.skeleton->setSkin(m_skin);
+        m_poses.emplace_back(std::move(pose));
+    }
+    else
+    {
+        m_poseIndices.erase(m_poses[index].key);
+    }
+
+    auto& pose = m_poses[index];
+    pose.key = key;
+    pose.lastUpdate = m_update;
+    m_poseIndices[key] = index;
+
+    return pose;
+}
+
+void Crowd::clear()
+{
+    m_poses.clear();
+    m_poseIndices.clear();
+}
+
+}
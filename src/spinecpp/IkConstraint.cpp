@@ -33,6 +33,7 @@
 #include <spinecpp/Skeleton.h>
 #include <spinecpp/Bone.h>
 #include <spinecpp/extension.h>
+#include <spinecpp/Trig.h>
 #include <cmath>
 #include <limits>
 
@@ -77,7 +78,7 @@ void IkConstraint::apply1(Bone& bone, Vector target, float alpha)
     float tx = (pos.x * pp->d - pos.y * pp->b) * id - bone.translation.x,
         ty = (pos.y * pp->a - pos.x * pp->c) * id - bone.translation.y;
 
-    float rotationIK = atan2(ty, tx) * RAD_DEG - bone.shear.x - bone.rotation;
+    float rotationIK = trig::atan2(ty, tx) * RAD_DEG - bone.shear.x - bone.rotation;
     if (bone.scale.x < 0) 
         rotationIK += 180;
     
@@ -154,12 +155,12 @@ void IkConstraint::apply2(Bone& parent, Bone& child, Vector target, int bendDir,
         else if (cosine > 1) cosine = 1;
         a2 = acos(cosine) * bendDir;
         a = l1 + l2 * cosine;
-        b = l2 * sin(a2);
-        a1 = atan2(ty * a - tx * b, tx * a + ty * b);
+        b = l2 * trig::sin(a2);
+        a1 = trig::atan2(ty * a - tx * b, tx * a + ty * b);
     }
     else {
         float a = psx * l2, b = psy * l2;
-        float aa = a * a, bb = b * b, ll = l1 * l1, dd = tx * tx + ty * ty, ta = atan2(ty, tx);
+        float aa = a * a, bb = b * b, ll = l1 * l1, dd = tx * tx + ty * ty, ta = trig::atan2(ty, tx);
         float c0 = bb * ll + aa * dd - aa * bb, c1 = -2 * bb * l1, c2 = bb - aa;
         float d = c1 * c1 - 4 * c2 * c0;
         float minAngle = 0, minDist = std::numeric_limits<float>::max(), minX = 0, minY = 0;
@@ -173,8 +174,8 @@ void IkConstraint::apply2(Bone& parent, Bone& child, Vector target, int bendDir,
             r = abs(r0) < abs(r1) ? r0 : r1;
             if (r * r <= dd) {
                 y = sqrt(dd - r * r) * bendDir;
-                a1 = ta - atan2(y, r);
-                a2 = atan2(y / psy, (r - l1) / psx);
+                a1 = ta - trig::atan2(y, r);
+                a2 = trig::atan2(y / psy, (r - l1) / psx);
                 goto outer;
             }
         }
@@ -191,8 +192,10 @@ void IkConstraint::apply2(Bone& parent, Bone& child, Vector target, int bendDir,
             minX = x;
         }
         angle = acos(-a * l1 / (aa - bb));
-        x = a * cos(angle) + l1;
-        y = b * sin(angle);
+        float sine, cosine;
+        trig::sincos(angle, sine, cosine);
+        x = a * cosine + l1;
+        y = b * sine;
         dist = x * x + y * y;
         if (dist < minDist) {
             minAngle = angle;
@@ -207,17 +210,17 @@ void IkConstraint::apply2(Bone& parent, Bone& child, Vector target, int bendDir,
             maxY = y;
         }
         if (dd <= (minDist + maxDist) / 2) {
-            a1 = ta - atan2(minY * bendDir, minX);
+            a1 = ta - trig::atan2(minY * bendDir, minX);
             a2 = minAngle * bendDir;
         }
         else {
-            a1 = ta - atan2(maxY * bendDir, maxX);
+            a1 = ta - trig::atan2(maxY * bendDir, maxX);
             a2 = maxAngle * bendDir;
         }
     }
 outer: 
     {
-        float os = atan2(cy, cx) * s2;
+        float os = trig::atan2(cy, cx) * s2;
         a1 = (a1 - os) * RAD_DEG + o1 - parent.rotation;
         if (a1 > 180) a1 -= 360;
         else if (a1 < -180) a1 += 360;
@@ -0,0 +1,450 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/KeyframeReduction.h>
+#include <spinecpp/Timelines.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace spine
+{
+
+namespace
+{
+
+inline float normalizeAngle(float angle)
+{
+    while (angle > 180)
+        angle -= 360;
+    while (angle < -180)
+        angle += 360;
+    return angle;
+}
+
+// Per timeline type access to the frame values
+struct RotateChannels
+{
+    typedef RotateTimeline::Frame Frame;
+    static const int count = 1;
+    static const bool angles = true;
+    static void get(const Frame& f, float* out) { out[0] = f.angle; }
+    static bool sameStep(const Frame&, const Frame&) { return true; }
+};
+
+template <typename TimelineT, Vector TimelineT::Frame::*Value>
+struct VectorChannels
+{
+    typedef typename TimelineT::Frame Frame;
+    static const int count = 2;
+    static const bool angles = false;
+    static void get(const Frame& f, float* out) { out[0] = (f.*Value).x; out[1] = (f.*Value).y; }
+    static bool sameStep(const Frame&, const Frame&) { return true; }
+};
+
+typedef VectorChannels<TranslateTimeline, &TranslateTimeline::Frame::translation> TranslateChannels;
+typedef VectorChannels<ScaleTimeline, &ScaleTimeline::Frame::scale> ScaleChannels;
+typedef VectorChannels<ShearTimeline, &ShearTimeline::Frame::shear> ShearChannels;
+
+struct ColorChannels
+{
+    typedef ColorTimeline::Frame Frame;
+    static const int count = 4;
+    static const bool angles = false;
+    static void get(const Frame& f, float* out) { out[0] = f.color.r; out[1] = f.color.g; out[2] = f.color.b; out[3] = f.color.a; }
+    static bool sameStep(const Frame&, const Frame&) { return true; }
+};
+
+struct IkConstraintChannels
+{
+    typedef IkConstraintTimeline::Frame Frame;
+    static const int count = 1;
+    static const bool angles = false;
+    static void get(const Frame& f, float* out) { out[0] = f.mix; }
+    // the bend direction is not interpolated
+    static bool sameStep(const Frame& a, const Frame& b) { return a.bendDirection == b.bendDirection; }
+};
+
+struct TransformConstraintChannels
+{
+    typedef TransformConstraintTimeline::Frame Frame;
+    static const int count = 4;
+    static const bool angles = false;
+    static void get(const Frame& f, float* out) { out[0] = f.rotateMix; out[1] = f.translateMix; out[2] = f.scaleMix; out[3] = f.shearMix; }
+    static bool sameStep(const Frame&, const Frame&) { return true; }
+};
+
+struct PathConstraintMixChannels
+{
+    typedef PathConstraintMixTimeline::Frame Frame;
+    static const int count = 2;
+    static const bool angles = false;
+    static void get(const Frame& f, float* out) { out[0] = f.rotateMix; out[1] = f.translateMix; }
+    static bool sameStep(const Frame&, const Frame&) { return true; }
+};
+
+// Reduces the frames of a curve timeline given the channels which describe its values
+template <typename Channels>
+class Reducer
+{
+public:
+    typedef typename Channels::Frame Frame;
+    static const int C = Channels::count;
+
+    // samples per original segment when measuring the error of a span
+    static const int SEGMENT_SAMPLES = 4;
+
+    Reducer(std::vector<Frame>& frames, float maxError, bool refitCurves)
+        : m_frames(frames)
+        , m_maxError(maxError)
+        , m_refitCurves(refitCurves)
+    {
+        m_values.resize(frames.size() * C);
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            Channels::get(frames[i], m_values.data() + i * C);
+        }
+    }
+
+    float reduce(std::vector<float>* outRemovedKeys)
+    {
+        auto& frames = m_frames;
+        if (frames.size() < 3) return 0;
+
+        // indices of the kept frames and the new curves for them
+        std::vector<size_t> kept;
+        std::vector<Curve> curves;
+
+        float maxError = 0;
+        size_t a = 0;
+        const size_t last = frames.size() - 1;
+        while (a < last)
+        {
+            size_t best = a + 1;
+            Curve bestCurve;
+            bestCurve.type = Curve::Original;
+            float bestError = 0;
+
+            for (size_t b = a + 2; b <= last; ++b)
+            {
+                if (!canMerge(a, b)) break;
+
+                Curve curve;
+                curve.type = Curve::Linear;
+                float error = spanError(a, b, curve);
+
+                if (error > m_maxError)
+                {
+                    if (!m_refitCurves || !fitCurve(a, b, curve)) break;
+                    error = spanError(a, b, curve);
+                    if (error > m_maxError) break;
+                }
+
+                best = b;
+                bestCurve = curve;
+                bestError = error;
+            }
+
+            kept.push_back(a);
+            curves.push_back(bestCurve);
+            maxError = std::max(maxError, bestError);
+
+            for (size_t i = a + 1; i < best; ++i)
+            {
+                if (outRemovedKeys) outRemovedKeys->push_back(frames[i].time);
+            }
+
+            a = best;
+        }
+
+        kept.push_back(last);
+        curves.push_back(Curve()); // last frame's curve is unused
+
+        if (kept.size() == frames.size()) return 0;
+
+        for (size_t i = 0; i < kept.size(); ++i)
+        {
+            // Only the bezierData pointer is copied, so the frame takes over the slot of the kept frame in the bezier
+            // data buffer of the timeline. The kept indices increase, so no two frames share a slot. The slots of the
+            // removed frames are left unused.
+            frames[i] = frames[kept[i]];
+
+            auto& curve = curves[i];
+            if (curve.type == Curve::Linear)
+            {
+                frames[i].setLinear();
+            }
+            else if (curve.type == Curve::Bezier)
+            {
+                frames[i].setCurve(curve.c1, curve.c2);
+            }
+        }
+
+        frames.erase(frames.begin() + kept.size(), frames.end());
+
+        return maxError;
+    }
+
+private:
+    struct Curve
+    {
+        enum
+        {
+            Original, // keep the frame's curve
+            Linear,
+            Bezier,
+        } type = Original;
+
+        Vector c1 = Vector(0, 0), c2 = Vector(1, 1);
+    };
+
+    const float* values(size_t frame) const { return m_values.data() + frame * C; }
+
+    float delta(float from, float to) const
+    {
+        return Channels::angles ? normalizeAngle(to - from) : to - from;
+    }
+
+    // frames a and b can be the ends of a span without the frames between them
+    bool canMerge(size_t a, size_t b) const
+    {
+        for (size_t i = a; i < b; ++i)
+        {
+            auto& f = m_frames[i];
+            if (f.type == CurveFrame::Type::Stepped) return false;
+            if (!(m_frames[i + 1].time > f.time)) return false;
+            if (!Channels::sameStep(m_frames[a], f)) return false;
+        }
+
+        return true;
+    }
+
+    // value of the original timeline in the segment starting at frame i
+    void originalValue(size_t i, float percent, float* out) const
+    {
+        percent = m_frames[i].getCurvePercent(percent);
+        auto from = values(i), to = values(i + 1);
+        for (int c = 0; c < C; ++c)
+        {
+            out[c] = from[c] + delta(from[c], to[c]) * percent;
+        }
+    }
+
+    // the maximum error of replacing the frames between a and b with the curve
+    float spanError(size_t a, size_t b, const Curve& curve) const
+    {
+        const float ta = m_frames[a].time, tb = m_frames[b].time;
+        auto va = values(a), vb = values(b);
+
+        // initialize the curve once for all samples
+        Vector bezierData[CurveFrame::BEZIER_DATA_SIZE];
+        CurveFrame frame;
+        frame.bezierData = bezierData;
+        if (curve.type == Curve::Bezier)
+        {
+            frame.setCurve(curve.c1, curve.c2);
+        }
+
+        float maxError = 0;
+        float original[C];
+        for (size_t i = a; i < b; ++i)
+        {
+            const float t0 = m_frames[i].time, t1 = m_frames[i + 1].time;
+            for (int s = 0; s < SEGMENT_SAMPLES; ++s)
+            {
+                if (i == a && s == 0) continue; // exact
+
+                float segmentPercent = float(s) / SEGMENT_SAMPLES;
+                originalValue(i, segmentPercent, original);
+
+                float t = t0 + (t1 - t0) * segmentPercent;
+                float percent = frame.getCurvePercent((t - ta) / (tb - ta));
+                for (int c = 0; c < C; ++c)
+                {
+                    float value = va[c] + delta(va[c], vb[c]) * percent;
+                    float error = std::abs(delta(value, original[c]));
+                    maxError = std::max(maxError, error);
+                }
+            }
+        }
+
+        return maxError;
+    }
+
+    // Least squares fit of the curve's control points to the original motion between frames a and b.
+    // The fit is done for the channel with the largest change. The other channels must move
+    // proportionally to it for the fit to be within the error bounds.
+    bool fitCurve(size_t a, size_t b, Curve& outCurve) const
+    {
+        auto va = values(a), vb = values(b);
+
+        int channel = 0;
+        float maxDelta = 0;
+        for (int c = 0; c < C; ++c)
+        {
+            float d = std::abs(delta(va[c], vb[c]));
+            if (d > maxDelta)
+            {
+                maxDelta = d;
+                channel = c;
+            }
+        }
+
+        if (maxDelta < 1e-6f) return false;
+
+        // samples of percent of time (x) to percent of value (y)
+        const float ta = m_frames[a].time, tb = m_frames[b].time;
+        const float d = delta(va[channel], vb[channel]);
+        std::vector<Vector> samples;
+        float original[C];
+        for (size_t i = a; i < b; ++i)
+        {
+            const float t0 = m_frames[i].time, t1 = m_frames[i + 1].time;
+            for (int s = 0; s < SEGMENT_SAMPLES; ++s)
+            {
+                if (i == a && s == 0) continue;
+                float segmentPercent = float(s) / SEGMENT_SAMPLES;
+                originalValue(i, segmentPercent, original);
+                float t = t0 + (t1 - t0) * segmentPercent;
+                samples.emplace_back((t - ta) / (tb - ta), delta(va[channel], original[channel]) / d);
+            }
+        }
+
+        // The x control points are chosen from a fixed set, for each pair the y control points are
+        // solved for as a linear least squares problem on the bernstein basis.
+        static const float xs[] = { 0.f, 0.1f, 0.2f, 0.25f, 0.333333f, 0.4f, 0.5f, 0.6f, 0.666667f, 0.75f, 0.8f, 0.9f, 1.f };
+        const int numXs = int(sizeof(xs) / sizeof(xs[0]));
+
+        float bestError = std::numeric_limits<float>::max();
+        for (int i = 0; i < numXs; ++i)
+        {
+            for (int j = 0; j < numXs; ++j)
+            {
+                Curve curve;
+                curve.type = Curve::Bezier;
+                curve.c1.x = xs[i];
+                curve.c2.x = xs[j];
+                if (!solveY(samples, curve)) continue;
+
+                float error = spanError(a, b, curve);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    outCurve = curve;
+                }
+            }
+        }
+
+        return bestError < std::numeric_limits<float>::max();
+    }
+
+    static float bezierX(float s, float cx1, float cx2)
+    {
+        float is = 1 - s;
+        return 3 * is * is * s * cx1 + 3 * is * s * s * cx2 + s * s * s;
+    }
+
+    static bool solveY(const std::vector<Vector>& samples, Curve& curve)
+    {
+        // normal equations for y(s) = b1(s) * cy1 + b2(s) * cy2 + s^3
+        float m11 = 0, m12 = 0, m22 = 0, r1 = 0, r2 = 0;
+        for (auto& sample : samples)
+        {
+            // find the curve parameter for x by bisection (x is monotonic in s)
+            float lo = 0, hi = 1;
+            for (int k = 0; k < 20; ++k)
+            {
+                float mid = (lo + hi) / 2;
+                if (bezierX(mid, curve.c1.x, curve.c2.x) < sample.x) lo = mid;
+                else hi = mid;
+            }
+            float s = (lo + hi) / 2, is = 1 - s;
+            float b1 = 3 * is * is * s, b2 = 3 * is * s * s;
+            float y = sample.y - s * s * s;
+            m11 += b1 * b1;
+            m12 += b1 * b2;
+            m22 += b2 * b2;
+            r1 += b1 * y;
+            r2 += b2 * y;
+        }
+
+        float det = m11 * m22 - m12 * m12;
+        if (std::abs(det) < 1e-12f) return false;
+
+        curve.c1.y = (r1 * m22 - r2 * m12) / det;
+        curve.c2.y = (r2 * m11 - r1 * m12) / det;
+        return true;
+    }
+
+    std::vector<Frame>& m_frames;
+    std::vector<float> m_values;
+    const float m_maxError;
+    const bool m_refitCurves;
+};
+
+template <typename Channels, typename TimelineT>
+float reduce(TimelineT& timeline, float maxError, const KeyframeReduction& settings, std::vector<float>* outRemovedKeys)
+{
+    if (maxError <= 0) return 0;
+
+    Reducer<Channels> reducer(timeline.frames, maxError, settings.refitCurves);
+    return reducer.reduce(outRemovedKeys);
+}
+
+}
+
+float reduceKeyframes(Timeline& timeline, const KeyframeReduction& settings, std::vector<float>* outRemovedKeys)
+{
+    switch (timeline.getType())
+    {
+    case Timeline::Type::Rotate:
+        return reduce<RotateChannels>(static_cast<RotateTimeline&>(timeline), settings.maxRotationError, settings, outRemovedKeys);
+    case Timeline::Type::Translate:
+        return reduce<TranslateChannels>(static_cast<TranslateTimeline&>(timeline), settings.maxTranslationError, settings, outRemovedKeys);
+    case Timeline::Type::Scale:
+        return reduce<ScaleChannels>(static_cast<ScaleTimeline&>(timeline), settings.maxScaleError, settings, outRemovedKeys);
+    case Timeline::Type::Shear:
+        return reduce<ShearChannels>(static_cast<ShearTimeline&>(timeline), settings.maxShearError, settings, outRemovedKeys);
+    case Timeline::Type::Color:
+        return reduce<ColorChannels>(static_cast<ColorTimeline&>(timeline), settings.maxColorError, settings, outRemovedKeys);
+    case Timeline::Type::IkConstraint:
+        return reduce<IkConstraintChannels>(static_cast<IkConstraintTimeline&>(timeline), settings.maxMixError, settings, outRemovedKeys);
+    case Timeline::Type::TransformConstraint:
+        return reduce<TransformConstraintChannels>(static_cast<TransformConstraintTimeline&>(timeline), settings.maxMixError, settings, outRemovedKeys);
+    case Timeline::Type::PathConstraintMix:
+        return reduce<PathConstraintMixChannels>(static_cast<PathConstraintMixTimeline&>(timeline), settings.maxMixError, settings, outRemovedKeys);
+    default:
+        return 0;
+    }
+}
+
+}
@@ -33,6 +33,7 @@
 #include <spinecpp/PathAttachment.h>
 #include <spinecpp/Skeleton.h>
 #include <spinecpp/extension.h>
+#include <spinecpp/Trig.h>
 
 #include <cstdlib>
 #include <cmath>
@@ -157,14 +158,14 @@ void PathConstraint::apply()
             else if (spaces[i + 1] == 0)
                 r = positions[i + 1].data;
             else
-                r = delta.angle();
+                r = trig::atan2(delta.y, delta.x);
 
-            r -= atan2(c, a) - offsetRotation * DEG_RAD;
+            r -= trig::atan2Double(c, a) - offsetRotation * DEG_RAD;
 
             if (tip)
             {
-                float cosine = std::cos(r);
-                float sine = std::sin(r);
+                float sine, cosine;
+                trig::sincos(r, sine, cosine);
                 float length = bone->data.length;
                 bonePos.x += (length * (cosine * a - sine * c) - delta.x) * rotateMix;
                 bonePos.y += (length * (sine * a + cosine * c) - delta.y) * rotateMix;
@@ -177,8 +178,8 @@ void PathConstraint::apply()
 
             r *= rotateMix;
 
-            float cosine = std::cos(r);
-            float sine = std::sin(r);
+            float sine, cosine;
+            trig::sincos(r, sine, cosine);
 
             bone->a = cosine * a - sine * c;
             bone->b = cosine * b - sine * d;
@@ -191,18 +192,22 @@ void PathConstraint::apply()
 void PathConstraint::addBeforePosition(float pos, int o)
 {
     auto delta = world[1] - world[0];
-    float r = delta.angle();
-    positions[o].position.x = world[0].x + pos * std::cos(r);
-    positions[o].position.y = world[0].y + pos * std::sin(r);
+    float r = trig::atan2(delta.y, delta.x);
+    float sine, cosine;
+    trig::sincos(r, sine, cosine);
+    positions[o].position.x = world[0].x + pos * cosine;
+    positions[o].position.y = world[0].y + pos * sine;
     positions[o].data = r;
 }
 
 void PathConstraint::addAfterPosition(float pos, int i, int o)
 {
     auto delta = world[i + 1] - world[i];
-    float r = delta.angle();
-    positions[o].position.x = world[i + 1].x + pos * std::cos(r);
-    positions[o].position.y = world[i + 1].y + pos * std::sin(r);
+    float r = trig::atan2(delta.y, delta.x);
+    float sine, cosine;
+    trig::sincos(r, sine, cosine);
+    positions[o].position.x = world[i + 1].x + pos * cosine;
+    positions[o].position.y = world[i + 1].y + pos * sine;
     positions[o].data = r;
 }
 
@@ -217,7 +222,7 @@ void PathConstraint::addCurvePosition(float p, float x1, float y1, float cx1, fl
     x = x1 * uuu + cx1 * uut3 + cx2 * utt3 + x2 * ttt, y = y1 * uuu + cy1 * uut3 + cy2 * utt3 + y2 * ttt;
     positions[o].position.x = x;
     positions[o].position.y = y;
-    if (tangents) positions[o].data = std::atan2(y - (y1 * uu + cy1 * ut * 2 + cy2 * tt), x - (x1 * uu + cx1 * ut * 2 + cx2 * tt));
+    if (tangents) positions[o].data = trig::atan2(y - (y1 * uu + cy1 * ut * 2 + cy2 * tt), x - (x1 * uu + cx1 * ut * 2 + cx2 * tt));
 }
 
 void PathConstraint::computeWorldPositions()
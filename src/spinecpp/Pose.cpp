@@ -0,0 +1,440 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/Pose.h>
+#include <spinecpp/Skeleton.h>
+#include <spinecpp/SkeletonData.h>
+
+#include <cassert>
+
+namespace spine
+{
+
+namespace
+{
+inline void normalizeAngle(float& angle)
+{
+    while (angle > 180)
+        angle -= 360;
+    while (angle < -180)
+        angle += 360;
+}
+}
+
+Pose::Pose(const SkeletonData& data)
+    : data(data)
+{
+    setToSetupPose();
+}
+
+Pose& Pose::operator=(const Pose& other)
+{
+    assert(&data == &other.data);
+
+    skin = other.skin;
+    bones = other.bones;
+    slots = other.slots;
+    drawOrder = other.drawOrder;
+    ikConstraints = other.ikConstraints;
+    transformConstraints = other.transformConstraints;
+    pathConstraints = other.pathConstraints;
+
+    return *this;
+}
+
+void Pose::setToSetupPose()
+{
+    bones.resize(data.bones.size());
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        auto& bd = data.bones[i];
+        auto& b = bones[i];
+        b.translation = bd.translation;
+        b.rotation = bd.rotation;
+        b.scale = bd.scale;
+        b.shear = bd.shear;
+    }
+
+    slots.resize(data.slots.size());
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        auto& sd = data.slots[i];
+        auto& s = slots[i];
+        s.color = sd.color;
+        s.attachment = sd.attachmentName.empty() ? nullptr : getAttachmentForSlotIndex(int(i), sd.attachmentName);
+    }
+
+    resetDrawOrder();
+
+    ikConstraints.resize(data.ikConstraints.size());
+    for (size_t i = 0; i < ikConstraints.size(); ++i)
+    {
+        auto& d = data.ikConstraints[i];
+        auto& ik = ikConstraints[i];
+        ik.bendDirection = d.bendDirection;
+        ik.mix = d.mix;
+    }
+
+    transformConstraints.resize(data.transformConstraints.size());
+    for (size_t i = 0; i < transformConstraints.size(); ++i)
+    {
+        auto& d = data.transformConstraints[i];
+        auto& tc = transformConstraints[i];
+        tc.rotateMix = d.rotateMix;
+        tc.translateMix = d.translateMix;
+        tc.scaleMix = d.scaleMix;
+        tc.shearMix = d.shearMix;
+    }
+
+    pathConstraints.resize(data.pathConstraints.size());
+    for (size_t i = 0; i < pathConstraints.size(); ++i)
+    {
+        auto& d = data.pathConstraints[i];
+        auto& pc = pathConstraints[i];
+        pc.position = d.position;
+        pc.spacing = d.spacing;
+        pc.rotateMix = d.rotateMix;
+        pc.translateMix = d.translateMix;
+    }
+}
+
+void Pose::resetDrawOrder()
+{
+    drawOrder.resize(data.slots.size());
+    for (size_t i = 0; i < drawOrder.size(); ++i)
+    {
+        drawOrder[i] = int(i);
+    }
+}
+
+void Pose::setFromSkeleton(const Skeleton& skeleton)
+{
+    assert(&skeleton.data == &data);
+
+    skin = skeleton.getSkin();
+
+    bones.resize(skeleton.bones.size());
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        bones[i] = skeleton.bones[i].getPose();
+    }
+
+    slots.resize(skeleton.slots.size());
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        auto& slot = skeleton.slots[i];
+        slots[i].color = slot.color;
+        slots[i].attachment = slot.getAttachment();
+    }
+
+    drawOrder.resize(skeleton.drawOrder.size());
+    for (size_t i = 0; i < drawOrder.size(); ++i)
+    {
+        drawOrder[i] = skeleton.drawOrder[i]->data.index;
+    }
+
+    ikConstraints.resize(skeleton.ikConstraints.size());
+    for (size_t i = 0; i < ikConstraints.size(); ++i)
+    {
+        auto& ik = skeleton.ikConstraints[i];
+        ikConstraints[i].bendDirection = ik.bendDirection;
+        ikConstraints[i].mix = ik.mix;
+    }
+
+    transformConstraints.resize(skeleton.transformConstraints.size());
+    for (size_t i = 0; i < transformConstraints.size(); ++i)
+    {
+        auto& tc = skeleton.transformConstraints[i];
+        auto& p = transformConstraints[i];
+        p.rotateMix = tc.rotateMix;
+        p.translateMix = tc.translateMix;
+        p.scaleMix = tc.scaleMix;
+        p.shearMix = tc.shearMix;
+    }
+
+    pathConstraints.resize(skeleton.pathConstraints.size());
+    for (size_t i = 0; i < pathConstraints.size(); ++i)
+    {
+        auto& pc = skeleton.pathConstraints[i];
+        auto& p = pathConstraints[i];
+        p.position = pc.position;
+        p.spacing = pc.spacing;
+        p.rotateMix = pc.rotateMix;
+        p.translateMix = pc.translateMix;
+    }
+}
+
+bool Pose::matches(const Skeleton& skeleton) const
+{
+    assert(&skeleton.data == &data);
+
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        auto& b = bones[i];
+        auto& bone = skeleton.bones[i];
+        if (b.rotation != bone.rotation || b.translation != bone.translation || b.scale != bone.scale || b.shear != bone.shear)
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        auto& slot = skeleton.slots[i];
+        if (slots[i].color != slot.color || slots[i].attachment != slot.getAttachment())
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < drawOrder.size(); ++i)
+    {
+        if (drawOrder[i] != skeleton.drawOrder[i]->data.index)
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < ikConstraints.size(); ++i)
+    {
+        auto& ik = skeleton.ikConstraints[i];
+        if (ikConstraints[i].bendDirection != ik.bendDirection || ikConstraints[i].mix != ik.mix)
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < transformConstraints.size(); ++i)
+    {
+        auto& tc = skeleton.transformConstraints[i];
+        auto& p = transformConstraints[i];
+        if (p.rotateMix != tc.rotateMix || p.translateMix != tc.translateMix || p.scaleMix != tc.scaleMix || p.shearMix != tc.shearMix)
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < pathConstraints.size(); ++i)
+    {
+        auto& pc = skeleton.pathConstraints[i];
+        auto& p = pathConstraints[i];
+        if (p.position != pc.position || p.spacing != pc.spacing || p.rotateMix != pc.rotateMix || p.translateMix != pc.translateMix)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Pose::applyTo(Skeleton& skeleton) const
+{
+    assert(&skeleton.data == &data);
+
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        skeleton.bones[i].setPose(bones[i]);
+    }
+
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        auto& slot = skeleton.slots[i];
+        slot.color = slots[i].color;
+        slot.setAttachment(slots[i].attachment);
+    }
+
+    skeleton.setDrawOrder(drawOrder.data());
+
+    for (size_t i = 0; i < ikConstraints.size(); ++i)
+    {
+        auto& ik = skeleton.ikConstraints[i];
+        ik.bendDirection = ikConstraints[i].bendDirection;
+        ik.mix = ikConstraints[i].mix;
+    }
+
+    for (size_t i = 0; i < transformConstraints.size(); ++i)
+    {
+        auto& tc = skeleton.transformConstraints[i];
+        auto& p = transformConstraints[i];
+        tc.rotateMix = p.rotateMix;
+        tc.translateMix = p.translateMix;
+        tc.scaleMix = p.scaleMix;
+        tc.shearMix = p.shearMix;
+    }
+
+    for (size_t i = 0; i < pathConstraints.size(); ++i)
+    {
+        auto& pc = skeleton.pathConstraints[i];
+        auto& p = pathConstraints[i];
+        pc.position = p.position;
+        pc.spacing = p.spacing;
+        pc.rotateMix = p.rotateMix;
+        pc.translateMix = p.translateMix;
+    }
+}
+
+void Pose::applySlotsAndConstraintsTo(Skeleton& skeleton, const AnimationTargets& targets) const
+{
+    assert(&skeleton.data == &data);
+
+    targets.slots.forEach([this, &skeleton](size_t i)
+    {
+        auto& slot = skeleton.slots[i];
+        slot.color = slots[i].color;
+        slot.setAttachment(slots[i].attachment);
+    });
+
+    if (targets.drawOrder)
+    {
+        skeleton.setDrawOrder(drawOrder.data());
+    }
+
+    targets.ikConstraints.forEach([this, &skeleton](size_t i)
+    {
+        auto& ik = skeleton.ikConstraints[i];
+        ik.bendDirection = ikConstraints[i].bendDirection;
+        ik.mix = ikConstraints[i].mix;
+    });
+
+    targets.transformConstraints.forEach([this, &skeleton](size_t i)
+    {
+        auto& tc = skeleton.transformConstraints[i];
+        auto& p = transformConstraints[i];
+        tc.rotateMix = p.rotateMix;
+        tc.translateMix = p.translateMix;
+        tc.scaleMix = p.scaleMix;
+        tc.shearMix = p.shearMix;
+    });
+
+    targets.pathConstraints.forEach([this, &skeleton](size_t i)
+    {
+        auto& pc = skeleton.pathConstraints[i];
+        auto& p = pathConstraints[i];
+        pc.position = p.position;
+        pc.spacing = p.spacing;
+        pc.rotateMix = p.rotateMix;
+        pc.translateMix = p.translateMix;
+    });
+}
+
+void Pose::blend(const Pose& target, float alpha)
+{
+    assert(&target.data == &data);
+
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        auto& b = bones[i];
+        auto& t = target.bones[i];
+
+        b.translation += (t.translation - b.translation) * alpha;
+
+        float amount = t.rotation - b.rotation;
+        normalizeAngle(amount);
+        b.rotation += amount * alpha;
+
+        b.scale += (t.scale - b.scale) * alpha;
+        b.shear += (t.shear - b.shear) * alpha;
+    }
+
+    bool discrete = alpha >= 0.5f;
+
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        auto& s = slots[i];
+        auto& t = target.slots[i];
+        s.color.r += (t.color.r - s.color.r) * alpha;
+        s.color.g += (t.color.g - s.color.g) * alpha;
+        s.color.b += (t.color.b - s.color.b) * alpha;
+        s.color.a += (t.color.a - s.color.a) * alpha;
+
+        if (discrete)
+        {
+            s.attachment = t.attachment;
+        }
+    }
+
+    if (discrete)
+    {
+        drawOrder = target.drawOrder;
+    }
+
+    for (size_t i = 0; i < ikConstraints.size(); ++i)
+    {
+        auto& ik = ikConstraints[i];
+        auto& t = target.ikConstraints[i];
+        ik.mix += (t.mix - ik.mix) * alpha;
+        if (discrete)
+        {
+            ik.bendDirection = t.bendDirection;
+        }
+    }
+
+    for (size_t i = 0; i < transformConstraints.size(); ++i)
+    {
+        auto& tc = transformConstraints[i];
+        auto& t = target.transformConstraints[i];
+        tc.rotateMix += (t.rotateMix - tc.rotateMix) * alpha;
+        tc.translateMix += (t.translateMix - tc.translateMix) * alpha;
+        tc.scaleMix += (t.scaleMix - tc.scaleMix) * alpha;
+        tc.shearMix += (t.shearMix - tc.shearMix) * alpha;
+    }
+
+    for (size_t i = 0; i < pathConstraints.size(); ++i)
+    {
+        auto& pc = pathConstraints[i];
+        auto& t = target.pathConstraints[i];
+        pc.position += (t.position - pc.position) * alpha;
+        pc.spacing += (t.spacing - pc.spacing) * alpha;
+        pc.rotateMix += (t.rotateMix - pc.rotateMix) * alpha;
+        pc.translateMix += (t.translateMix - pc.translateMix) * alpha;
+    }
+}
+
+const Attachment* Pose::getAttachmentForSlotIndex(int slotIndex, const std::string& attachmentName) const
+{
+    if (slotIndex == -1) return nullptr;
+
+    if (skin)
+    {
+        auto attachment = skin->getAttachment(slotIndex, attachmentName.c_str());
+        if (attachment) return attachment;
+    }
+
+    if (data.defaultSkin)
+    {
+        auto attachment = data.defaultSkin->getAttachment(slotIndex, attachmentName.c_str());
+        if (attachment) return attachment;
+    }
+
+    return nullptr;
+}
+
+}
@@ -0,0 +1,443 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/PoseCache.h>
+#include <spinecpp/Animation.h>
+#include <spinecpp/SkeletonData.h>
+#include <spinecpp/Skeleton.h>
+#include <spinecpp/Timelines.h>
+#include <spinecpp/QuantizedTimelines.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace spine
+{
+
+namespace
+{
+
+inline void normalizeAngle(float& angle)
+{
+    while (angle > 180)
+        angle -= 360;
+    while (angle < -180)
+        angle += 360;
+}
+
+template <typename T>
+size_t vectorSize(const std::vector<T>& v)
+{
+    return v.capacity() * sizeof(T);
+}
+
+// Appends the elements of source at the indices to target
+template <typename T>
+void appendIndexed(std::vector<T>& target, const std::vector<T>& source, const std::vector<int>& indices)
+{
+    for (auto i : indices)
+    {
+        target.push_back(source[i]);
+    }
+}
+
+}
+
+BakedAnimation::BakedAnimation(const Animation& animation, float fps)
+    : animation(animation)
+    , fps(fps)
+{
+}
+
+float BakedAnimation::getSampleTime(int sample) const
+{
+    return std::min(float(sample) / fps, animation.duration);
+}
+
+void BakedAnimation::bake(const SkeletonData& data)
+{
+    animation.lockTimelines();
+
+    auto& targets = animation.targets;
+    targets.bones.forEach([this](size_t i) { m_bones.push_back(int(i)); });
+    targets.ikConstraints.forEach([this](size_t i) { m_ikConstraints.push_back(int(i)); });
+    targets.transformConstraints.forEach([this](size_t i) { m_transformConstraints.push_back(int(i)); });
+    targets.pathConstraints.forEach([this](size_t i) { m_pathConstraints.push_back(int(i)); });
+    m_drawOrder = targets.drawOrder;
+
+    std::vector<const AttachmentTimeline*> attachmentTimelines;
+
+    auto& timelines = animation.timelines;
+    for (size_t i = 0; i < timelines.size(); ++i)
+    {
+        auto t = timelines[i];
+        switch (t->getType())
+        {
+        case Timeline::Type::Color:
+            m_colorSlots.push_back(static_cast<const ColorTimeline*>(t)->slotIndex);
+            break;
+        case Timeline::Type::QuantizedColor:
+            m_colorSlots.push_back(static_cast<const QuantizedColorTimeline*>(t)->slotIndex);
+            break;
+        case Timeline::Type::Attachment:
+            attachmentTimelines.push_back(static_cast<const AttachmentTimeline*>(t));
+            m_attachmentSlots.push_back(attachmentTimelines.back()->slotIndex);
+            break;
+        case Timeline::Type::Deform:
+        case Timeline::Type::Event:
+            m_liveTimelines.push_back(int(i));
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::sort(m_colorSlots.begin(), m_colorSlots.end());
+    m_colorSlots.erase(std::unique(m_colorSlots.begin(), m_colorSlots.end()), m_colorSlots.end());
+
+    m_numSamples = animation.duration > 0 ? int(std::ceil(animation.duration * fps)) + 1 : 1;
+
+    m_bonePoses.reserve(m_numSamples * m_bones.size());
+    m_colors.reserve(m_numSamples * m_colorSlots.size());
+    m_attachments.reserve(m_numSamples * m_attachmentSlots.size());
+    m_drawOrders.reserve(m_drawOrder ? m_numSamples * data.slots.size() : 0);
+    m_ikPoses.reserve(m_numSamples * m_ikConstraints.size());
+    m_transformPoses.reserve(m_numSamples * m_transformConstraints.size());
+    m_pathPoses.reserve(m_numSamples * m_pathConstraints.size());
+
+    Pose pose(data);
+    for (int s = 0; s < m_numSamples; ++s)
+    {
+        float time = getSampleTime(s);
+
+        pose.setToSetupPose();
+        animation.sampleInto(pose, time, false);
+
+        appendIndexed(m_bonePoses, pose.bones, m_bones);
+
+        for (auto i : m_colorSlots)
+        {
+            m_colors.push_back(pose.slots[i].color);
+        }
+
+        // Attachments depend on the skin, so their names are stored and looked up on playback.
+        for (auto t : attachmentTimelines)
+        {
+            auto& frames = t->frames;
+            auto frame = std::upper_bound(frames.begin(), frames.end(), time, [](float time, const AttachmentTimeline::Frame& f)
+            {
+                return time < f.time;
+            });
+
+            int attachment = -2;
+            if (frame != frames.begin())
+            {
+                auto& name = (frame - 1)->attachmentName;
+                if (name.empty())
+                {
+                    attachment = -1;
+                }
+                else
+                {
+                    auto found = std::find(m_attachmentNames.begin(), m_attachmentNames.end(), name);
+                    attachment = int(found - m_attachmentNames.begin());
+                    if (found == m_attachmentNames.end())
+                    {
+                        m_attachmentNames.push_back(name);
+                    }
+                }
+            }
+
+            m_attachments.push_back(attachment);
+        }
+
+        if (m_drawOrder)
+        {
+            m_drawOrders.insert(m_drawOrders.end(), pose.drawOrder.begin(), pose.drawOrder.end());
+        }
+
+        appendIndexed(m_ikPoses, pose.ikConstraints, m_ikConstraints);
+        appendIndexed(m_transformPoses, pose.transformConstraints, m_transformConstraints);
+        appendIndexed(m_pathPoses, pose.pathConstraints, m_pathConstraints);
+    }
+
+    animation.unlockTimelines();
+}
+
+size_t BakedAnimation::getSize() const
+{
+    size_t size = sizeof(BakedAnimation);
+
+    size += vectorSize(m_bones) + vectorSize(m_colorSlots) + vectorSize(m_attachmentSlots);
+    size += vectorSize(m_ikConstraints) + vectorSize(m_transformConstraints) + vectorSize(m_pathConstraints);
+    size += vectorSize(m_liveTimelines);
+
+    size += vectorSize(m_bonePoses) + vectorSize(m_colors) + vectorSize(m_attachments) + vectorSize(m_drawOrders);
+    size += vectorSize(m_ikPoses) + vectorSize(m_transformPoses) + vectorSize(m_pathPoses);
+
+    size += vectorSize(m_attachmentNames);
+    for (auto& name : m_attachmentNames)
+    {
+        size += name.capacity();
+    }
+
+    return size;
+}
+
+void BakedAnimation::apply(Skeleton& skeleton, float lastTime, float time, int loop, std::vector<const Event*>* outEvents, BakedSampling sampling) const
+{
+    animation.getLoopTimes(lastTime, time, loop);
+
+    // find the sample pair around the time
+    int sample = 0, nextSample = 0;
+    float alpha = 0;
+    if (time > 0 && m_numSamples > 1)
+    {
+        sample = std::min(int(time * fps), m_numSamples - 1);
+        nextSample = std::min(sample + 1, m_numSamples - 1);
+
+        if (nextSample != sample)
+        {
+            float sampleTime = getSampleTime(sample);
+            alpha = std::min((time - sampleTime) / (getSampleTime(nextSample) - sampleTime), 1.f);
+        }
+
+        if (sampling == BakedSampling::Nearest)
+        {
+            if (alpha >= 0.5f)
+            {
+                sample = nextSample;
+            }
+            alpha = 0;
+        }
+    }
+
+    if (alpha == 0)
+    {
+        auto poses = m_bonePoses.data() + sample * m_bones.size();
+        for (size_t i = 0; i < m_bones.size(); ++i)
+        {
+            skeleton.bones[m_bones[i]].setPose(poses[i]);
+        }
+
+        auto colors = m_colors.data() + sample * m_colorSlots.size();
+        for (size_t i = 0; i < m_colorSlots.size(); ++i)
+        {
+            skeleton.slots[m_colorSlots[i]].color = colors[i];
+        }
+
+        auto ik = m_ikPoses.data() + sample * m_ikConstraints.size();
+        for (size_t i = 0; i < m_ikConstraints.size(); ++i)
+        {
+            auto& c = skeleton.ikConstraints[m_ikConstraints[i]];
+            c.bendDirection = ik[i].bendDirection;
+            c.mix = ik[i].mix;
+        }
+
+        auto tc = m_transformPoses.data() + sample * m_transformConstraints.size();
+        for (size_t i = 0; i < m_transformConstraints.size(); ++i)
+        {
+            auto& c = skeleton.transformConstraints[m_transformConstraints[i]];
+            c.rotateMix = tc[i].rotateMix;
+            c.translateMix = tc[i].translateMix;
+            c.scaleMix = tc[i].scaleMix;
+            c.shearMix = tc[i].shearMix;
+        }
+
+        auto pc = m_pathPoses.data() + sample * m_pathConstraints.size();
+        for (size_t i = 0; i < m_pathConstraints.size(); ++i)
+        {
+            auto& c = skeleton.pathConstraints[m_pathConstraints[i]];
+            c.position = pc[i].position;
+            c.spacing = pc[i].spacing;
+            c.rotateMix = pc[i].rotateMix;
+            c.translateMix = pc[i].translateMix;
+        }
+    }
+    else
+    {
+        auto poses = m_bonePoses.data() + sample * m_bones.size();
+        auto nextPoses = m_bonePoses.data() + nextSample * m_bones.size();
+        for (size_t i = 0; i < m_bones.size(); ++i)
+        {
+            auto& p = poses[i];
+            auto& n = nextPoses[i];
+
+            BonePose pose;
+            pose.translation = p.translation + (n.translation - p.translation) * alpha;
+
+            float amount = n.rotation - p.rotation;
+            normalizeAngle(amount);
+            pose.rotation = p.rotation + amount * alpha;
+
+            pose.scale = p.scale + (n.scale - p.scale) * alpha;
+            pose.shear = p.shear + (n.shear - p.shear) * alpha;
+
+            skeleton.bones[m_bones[i]].setPose(pose);
+        }
+
+        auto colors = m_colors.data() + sample * m_colorSlots.size();
+        auto nextColors = m_colors.data() + nextSample * m_colorSlots.size();
+        for (size_t i = 0; i < m_colorSlots.size(); ++i)
+        {
+            auto& c = colors[i];
+            auto& n = nextColors[i];
+            auto& color = skeleton.slots[m_colorSlots[i]].color;
+            color.r = c.r + (n.r - c.r) * alpha;
+            color.g = c.g + (n.g - c.g) * alpha;
+            color.b = c.b + (n.b - c.b) * alpha;
+            color.a = c.a + (n.a - c.a) * alpha;
+        }
+
+        auto ik = m_ikPoses.data() + sample * m_ikConstraints.size();
+        auto nextIk = m_ikPoses.data() + nextSample * m_ikConstraints.size();
+        for (size_t i = 0; i < m_ikConstraints.size(); ++i)
+        {
+            auto& c = skeleton.ikConstraints[m_ikConstraints[i]];
+            c.bendDirection = ik[i].bendDirection;
+            c.mix = ik[i].mix + (nextIk[i].mix - ik[i].mix) * alpha;
+        }
+
+        auto tc = m_transformPoses.data() + sample * m_transformConstraints.size();
+        auto nextTc = m_transformPoses.data() + nextSample * m_transformConstraints.size();
+        for (size_t i = 0; i < m_transformConstraints.size(); ++i)
+        {
+            auto& c = skeleton.transformConstraints[m_transformConstraints[i]];
+            c.rotateMix = tc[i].rotateMix + (nextTc[i].rotateMix - tc[i].rotateMix) * alpha;
+            c.translateMix = tc[i].translateMix + (nextTc[i].translateMix - tc[i].translateMix) * alpha;
+            c.scaleMix = tc[i].scaleMix + (nextTc[i].scaleMix - tc[i].scaleMix) * alpha;
+            c.shearMix = tc[i].shearMix + (nextTc[i].shearMix - tc[i].shearMix) * alpha;
+        }
+
+        auto pc = m_pathPoses.data() + sample * m_pathConstraints.size();
+        auto nextPc = m_pathPoses.data() + nextSample * m_pathConstraints.size();
+        for (size_t i = 0; i < m_pathConstraints.size(); ++i)
+        {
+            auto& c = skeleton.pathConstraints[m_pathConstraints[i]];
+            c.position = pc[i].position + (nextPc[i].position - pc[i].position) * alpha;
+            c.spacing = pc[i].spacing + (nextPc[i].spacing - pc[i].spacing) * alpha;
+            c.rotateMix = pc[i].rotateMix + (nextPc[i].rotateMix - pc[i].rotateMix) * alpha;
+            c.translateMix = pc[i].translateMix + (nextPc[i].translateMix - pc[i].translateMix) * alpha;
+        }
+    }
+
+    // discrete values come from the earlier sample
+    auto attachments = m_attachments.data() + sample * m_attachmentSlots.size();
+    for (size_t i = 0; i < m_attachmentSlots.size(); ++i)
+    {
+        int attachment = attachments[i];
+        if (attachment == -2) continue;
+
+        auto& slot = skeleton.slots[m_attachmentSlots[i]];
+        slot.setAttachment(attachment < 0 ? nullptr : skeleton.getAttachmentForSlotIndex(slot.data.index, m_attachmentNames[attachment]));
+    }
+
+    if (m_drawOrder)
+    {
+        skeleton.setDrawOrder(m_drawOrders.data() + sample * skeleton.slots.size());
+    }
+
+    if (!m_liveTimelines.empty())
+    {
+        animation.lockTimelines();
+        for (auto i : m_liveTimelines)
+        {
+            animation.timelines[i]->apply(skeleton, lastTime, time, outEvents, 1);
+        }
+        animation.unlockTimelines();
+    }
+}
+
+PoseCache::PoseCache(const SkeletonData& data)
+    : m_data(data)
+{
+}
+
+PoseCache::~PoseCache()
+{
+}
+
+const BakedAnimation* PoseCache::bake(const Animation& animation, float fps)
+{
+    auto existing = find(animation);
+    if (existing)
+    {
+        if (existing->fps == fps) return existing;
+        remove(animation);
+    }
+
+    std::unique_ptr<BakedAnimation> baked(new BakedAnimation(animation, fps));
+    baked->bake(m_data);
+
+    size_t size = baked->getSize();
+    if (m_size + size > m_budget)
+    {
+        return nullptr;
+    }
+
+    m_size += size;
+    m_animations.emplace_back(std::move(baked));
+    return m_animations.back().get();
+}
+
+const BakedAnimation* PoseCache::find(const Animation& animation) const
+{
+    for (auto& baked : m_animations)
+    {
+        if (&baked->animation == &animation)
+        {
+            return baked.get();
+        }
+    }
+
+    return nullptr;
+}
+
+void PoseCache::remove(const Animation& animation)
+{
+    for (auto i = m_animations.begin(); i != m_animations.end(); ++i)
+    {
+        if (&(*i)->animation == &animation)
+        {
+            m_size -= (*i)->getSize();
+            m_animations.erase(i);
+            return;
+        }
+    }
+}
+
+void PoseCache::clear()
+{
+    m_animations.clear();
+    m_size = 0;
+}
+
+}
@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/PoseLod.h>
+#include <spinecpp/Skeleton.h>
+#include <spinecpp/AnimationState.h>
+
+#include <cassert>
+
+namespace spine
+{
+
+PoseLod PoseLodPolicy::getLod(float distance, bool visible) const
+{
+    if (!visible) return invisible;
+
+    PoseLod lod;
+    if (distance >= eighthRateDistance) lod.rate = 8;
+    else if (distance >= quarterRateDistance) lod.rate = 4;
+    else if (distance >= halfRateDistance) lod.rate = 2;
+
+    lod.constraints = distance < noConstraintsDistance;
+    lod.deform = distance < noDeformDistance;
+
+    return lod;
+}
+
+void PoseLodScheduler::update(PoseLodInstance* instances, size_t count, float delta)
+{
+    ++m_frame;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& instance = instances[i];
+        auto& lod = instance.lod;
+        assert(lod.rate == 1 || lod.rate == 2 || lod.rate == 4 || lod.rate == 8);
+
+        auto& skeleton = *instance.skeleton;
+        auto& state = *instance.state;
+
+        bool pose;
+        if (instance.phase < 0 || instance.phaseRate != lod.rate)
+        {
+            int rateIndex = lod.rate == 1 ? 0 : lod.rate == 2 ? 1 : lod.rate == 4 ? 2 : 3;
+            unsigned phase = m_nextPhases[rateIndex]++ % unsigned(lod.rate);
+
+            // a new instance is posed right away, one with a changed rate on the next frame of its phase
+            pose = instance.phase < 0 || (m_frame + phase) % unsigned(lod.rate) == 0;
+
+            instance.phase = int(phase);
+            instance.phaseRate = lod.rate;
+        }
+        else
+        {
+            pose = (m_frame + unsigned(instance.phase)) % unsigned(lod.rate) == 0;
+        }
+
+        skeleton.update(delta);
+        state.update(delta);
+
+        instance.posed = pose;
+        if (!pose)
+        {
+            state.applyEvents(skeleton);
+            continue;
+        }
+
+        if (resetTargets)
+        {
+            state.setTargetsToSetupPose(skeleton);
+        }
+
+        bool applyDeform = state.applyDeform;
+        state.applyDeform = applyDeform && lod.deform;
+        state.apply(skeleton);
+        state.applyDeform = applyDeform;
+
+        if (lod.constraints)
+        {
+            skeleton.updateWorldTransform();
+        }
+        else
+        {
+            skeleton.updateWorldTransformWithoutConstraints();
+        }
+    }
+}
+
+}
@@ -0,0 +1,629 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+#include <spinecpp/QuantizedTimelines.h>
+#include <spinecpp/Timelines.h>
+#include <spinecpp/Skeleton.h>
+#include <spinecpp/Bone.h>
+#include <spinecpp/Slot.h>
+#include <spinecpp/Pose.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace spine
+{
+
+namespace
+{
+// time here is in frames (time * fps)
+template <typename Frame>
+typename std::vector<Frame>::const_iterator findFrame(const std::vector<Frame>& frames, float time)
+{
+    return std::upper_bound(frames.begin(), frames.end(), time, [](float t, const Frame& f) -> bool
+    {
+        return t < f.time;
+    });
+}
+
+// Same as findFrame, but the search starts at the hint (if not null), which is updated with the found frame.
+// Searches for increasing times with the same hint only step over the frames in between.
+template <typename Frame>
+typename std::vector<Frame>::const_iterator findFrame(const std::vector<Frame>& frames, float time, size_t* hint)
+{
+    if (!hint || *hint == 0 || *hint > frames.size() || time < frames[*hint - 1].time)
+    {
+        auto frame = findFrame(frames, time);
+        if (hint) *hint = frame - frames.begin();
+        return frame;
+    }
+
+    size_t i = *hint;
+    while (i < frames.size() && !(time < frames[i].time))
+    {
+        ++i;
+    }
+
+    *hint = i;
+    return frames.begin() + i;
+}
+
+inline void normalizeAngle(float& angle)
+{
+    while (angle > 180)
+        angle -= 360;
+    while (angle < -180)
+        angle += 360;
+}
+
+inline float saturate(float f)
+{
+    if (f < 0) return 0;
+    if (f > 1) return 1;
+    return f;
+}
+
+const float MAX_QUANTIZED = 65535;
+
+// Fills the frame times of a quantized timeline from the source frames.
+// Returns false if any of the keys are off the frame grid, or if two keys fall on the same frame (the interpolation
+// between them would divide by zero).
+template <typename SrcFrame, typename Frame>
+bool quantizeTimes(const std::vector<SrcFrame>& src, const TimelineQuantization& settings, std::vector<Frame>& frames)
+{
+    if (settings.fps <= 0) return false;
+
+    // every frame could have a different curve
+    if (src.size() > size_t(MAX_QUANTIZED - QuantizedCurveTimeline::Curve_Bezier)) return false;
+
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        float frame = std::round(src[i].time * settings.fps);
+        if (frame < 0 || frame > MAX_QUANTIZED) return false;
+        if (std::abs(frame / settings.fps - src[i].time) > settings.maxTimeError) return false;
+        if (i > 0 && uint16_t(frame) <= frames[i - 1].time) return false;
+        frames[i].time = uint16_t(frame);
+    }
+
+    return true;
+}
+
+// Fills range to fit values and returns the maximum error of the quantization
+float quantizeRange(const std::vector<float>& values, QuantizationRange& range, std::vector<uint16_t>& outValues)
+{
+    auto minmax = std::minmax_element(values.begin(), values.end());
+    range.min = *minmax.first;
+    range.step = (*minmax.second - *minmax.first) / MAX_QUANTIZED;
+
+    outValues.resize(values.size());
+
+    float maxError = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        uint16_t q = 0;
+        if (range.step > 0)
+        {
+            q = uint16_t(std::min(std::round((values[i] - range.min) / range.step), MAX_QUANTIZED));
+        }
+
+        outValues[i] = q;
+        maxError = std::max(maxError, std::abs(range.get(q) - values[i]));
+    }
+
+    return maxError;
+}
+
+template <typename SrcFrame, typename Frame>
+void quantizeCurves(const std::vector<SrcFrame>& src, QuantizedCurveTimeline& timeline, std::vector<Frame>& frames)
+{
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        frames[i].curve = timeline.addCurve(src[i]);
+    }
+}
+
+Timeline* quantizeRotate(const RotateTimeline& src, const TimelineQuantization& settings)
+{
+    if (settings.maxRotationError <= 0) return nullptr;
+
+    std::unique_ptr<QuantizedRotateTimeline> timeline(new QuantizedRotateTimeline(int(src.frames.size()), settings.fps));
+    if (!quantizeTimes(src.frames, settings, timeline->frames)) return nullptr;
+
+    std::vector<float> values;
+    values.reserve(src.frames.size());
+    for (auto& f : src.frames)
+    {
+        values.emplace_back(f.angle);
+    }
+
+    std::vector<uint16_t> q;
+    if (quantizeRange(values, timeline->angleRange, q) > settings.maxRotationError) return nullptr;
+
+    for (size_t i = 0; i < q.size(); ++i)
+    {
+        timeline->frames[i].angle = q[i];
+    }
+
+    quantizeCurves(src.frames, *timeline, timeline->frames);
+    timeline->boneIndex = src.boneIndex;
+    return timeline.release();
+}
+
+template <typename QuantizedTimeline, typename SrcTimeline>
+Timeline* quantizeVector(const SrcTimeline& src, Vector SrcTimeline::Frame::*value, float maxError, const TimelineQuantization& settings)
+{
+    if (maxError <= 0) return nullptr;
+
+    std::unique_ptr<QuantizedTimeline> timeline(new QuantizedTimeline(int(src.frames.size()), settings.fps));
+    if (!quantizeTimes(src.frames, settings, timeline->frames)) return nullptr;
+
+    std::vector<float> xs, ys;
+    xs.reserve(src.frames.size());
+    ys.reserve(src.frames.size());
+    for (auto& f : src.frames)
+    {
+        xs.emplace_back((f.*value).x);
+        ys.emplace_back((f.*value).y);
+    }
+
+    std::vector<uint16_t> qx, qy;
+    if (quantizeRange(xs, timeline->xRange, qx) > maxError) return nullptr;
+    if (quantizeRange(ys, timeline->yRange, qy) > maxError) return nullptr;
+
+    for (size_t i = 0; i < qx.size(); ++i)
+    {
+        timeline->frames[i].x = qx[i];
+        timeline->frames[i].y = qy[i];
+    }
+
+    quantizeCurves(src.frames, *timeline, timeline->frames);
+    timeline->boneIndex = src.boneIndex;
+    return timeline.release();
+}
+
+inline uint8_t quantizeColorComponent(float c)
+{
+    return uint8_t(std::round(saturate(c) * 255));
+}
+
+Timeline* quantizeColor(const ColorTimeline& src, const TimelineQuantization& settings)
+{
+    if (!settings.quantizeColors) return nullptr;
+
+    std::unique_ptr<QuantizedColorTimeline> timeline(new QuantizedColorTimeline(int(src.frames.size()), settings.fps));
+    if (!quantizeTimes(src.frames, settings, timeline->frames)) return nullptr;
+
+    for (size_t i = 0; i < src.frames.size(); ++i)
+    {
+        auto& color = src.frames[i].color;
+        auto& frame = timeline->frames[i];
+        frame.r = quantizeColorComponent(color.r);
+        frame.g = quantizeColorComponent(color.g);
+        frame.b = quantizeColorComponent(color.b);
+        frame.a = quantizeColorComponent(color.a);
+    }
+
+    quantizeCurves(src.frames, *timeline, timeline->frames);
+    timeline->slotIndex = src.slotIndex;
+    return timeline.release();
+}
+
+}
+
+Timeline* quantizeTimeline(const Timeline& timeline, const TimelineQuantization& settings)
+{
+    switch (timeline.getType())
+    {
+    case Timeline::Type::Rotate:
+        return quantizeRotate(static_cast<const RotateTimeline&>(timeline), settings);
+    case Timeline::Type::Translate:
+        return quantizeVector<QuantizedTranslateTimeline>(static_cast<const TranslateTimeline&>(timeline),
+            &TranslateTimeline::Frame::translation, settings.maxTranslationError, settings);
+    case Timeline::Type::Scale:
+        return quantizeVector<QuantizedScaleTimeline>(static_cast<const ScaleTimeline&>(timeline),
+            &ScaleTimeline::Frame::scale, settings.maxScaleError, settings);
+    case Timeline::Type::Shear:
+        return quantizeVector<QuantizedShearTimeline>(static_cast<const ShearTimeline&>(timeline),
+            &ShearTimeline::Frame::shear, settings.maxShearError, settings);
+    case Timeline::Type::Color:
+        return quantizeColor(static_cast<const ColorTimeline&>(timeline), settings);
+    default:
+        return nullptr;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+QuantizedCurveTimeline::QuantizedCurveTimeline(Timeline::Type type, float fps)
+    : Timeline(type)
+    , m_fps(fps)
+{
+}
+
+uint16_t QuantizedCurveTimeline::addCurve(const CurveFrame& source)
+{
+    switch (source.type)
+    {
+    case CurveFrame::Type::Linear:
+        return Curve_Linear;
+    case CurveFrame::Type::Stepped:
+        return Curve_Stepped;
+    default:
+        break;
+    }
+
+    const auto size = CurveFrame::BEZIER_DATA_SIZE;
+
+    // baked animations often have many identical curves, so reuse those
+    size_t numCurves = m_bezierData.size() / size;
+    for (size_t i = 0; i < numCurves; ++i)
+    {
+        if (memcmp(m_bezierData.data() + i * size, source.bezierData, size * sizeof(Vector)) == 0)
+        {
+            return uint16_t(Curve_Bezier + i);
+        }
+    }
+
+    m_bezierData.insert(m_bezierData.end(), source.bezierData, source.bezierData + size);
+    return uint16_t(Curve_Bezier + numCurves);
+}
+
+float QuantizedCurveTimeline::getCurvePercent(uint16_t curve, float percent) const
+{
+    percent = saturate(percent);
+    if (curve == Curve_Linear) return percent;
+    if (curve == Curve_Stepped) return 0;
+
+    auto bezierData = m_bezierData.data() + (curve - Curve_Bezier) * CurveFrame::BEZIER_DATA_SIZE;
+    return CurveFrame::getBezierCurvePercent(bezierData, percent);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+QuantizedRotateTimeline::QuantizedRotateTimeline(int framesCount, float fps)
+    : QuantizedCurveTimeline(Timeline::Type::QuantizedRotate, fps)
+{
+    frames.resize(framesCount);
+}
+
+void QuantizedRotateTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    auto& bone = skeleton.bones[boneIndex];
+    applyToValue(bone.data, time, alpha, bone.rotation, nullptr);
+}
+
+void QuantizedRotateTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(pose.data.bones[boneIndex], time, alpha, pose.bones[boneIndex].rotation, nullptr);
+}
+
+int QuantizedRotateTimeline::getBoneIndex() const
+{
+    return boneIndex;
+}
+
+void QuantizedRotateTimeline::applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const
+{
+    applyToValue(data, time, alpha, pose.rotation, frameHint);
+}
+
+void QuantizedRotateTimeline::applyToValue(const BoneData& data, float time, float alpha, float& inOutRotation, size_t* frameHint) const
+{
+    float frame = time * m_fps;
+
+    if (frame < frames.front().time) return; // time is before first frame
+
+    if (frame >= frames.back().time) // time is after last frame
+    {
+        float amount = data.rotation + angleRange.get(frames.back().angle) - inOutRotation;
+        normalizeAngle(amount);
+        inOutRotation += amount * alpha;
+        return;
+    }
+
+    // Interpolate between the previous frame and the current frame.
+    auto curFrame = findFrame(frames, frame, frameHint);
+    auto prevFrame = curFrame - 1;
+
+    float percent = 1 - (frame - curFrame->time) / float(prevFrame->time - curFrame->time);
+    percent = getCurvePercent(prevFrame->curve, percent);
+
+    float prevAngle = angleRange.get(prevFrame->angle);
+    float amount = angleRange.get(curFrame->angle) - prevAngle;
+    normalizeAngle(amount);
+    amount = data.rotation + (prevAngle + amount * percent) - inOutRotation;
+    normalizeAngle(amount);
+    inOutRotation += amount * alpha;
+}
+
+void QuantizedRotateTimeline::clearIdentityFrames()
+{
+    auto angle = frames.front().angle;
+    for (size_t i = 1; i < frames.size(); ++i)
+    {
+        if (frames[i].angle != angle)
+        {
+            return;
+        }
+    }
+
+    frames.erase(frames.begin() + 1, frames.end());
+}
+
+void QuantizedRotateTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.bones.set(boneIndex);
+}
+
+float QuantizedRotateTimeline::getLastFrameTime() const
+{
+    return frames.back().time / m_fps;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+QuantizedVectorTimeline::QuantizedVectorTimeline(int framesCount, float fps, Timeline::Type type)
+    : QuantizedCurveTimeline(type, fps)
+{
+    frames.resize(framesCount);
+}
+
+bool QuantizedVectorTimeline::getValue(float time, Vector& outValue, size_t* frameHint) const
+{
+    float frame = time * m_fps;
+
+    if (frame < frames.front().time) return false; // time is before first frame
+
+    if (frame >= frames.back().time) // time is after last frame
+    {
+        outValue.x = xRange.get(frames.back().x);
+        outValue.y = yRange.get(frames.back().y);
+        return true;
+    }
+
+    // Interpolate between the previous frame and the current frame.
+    auto curFrame = findFrame(frames, frame, frameHint);
+    auto prevFrame = curFrame - 1;
+
+    float percent = 1 - (frame - curFrame->time) / float(prevFrame->time - curFrame->time);
+    percent = getCurvePercent(prevFrame->curve, percent);
+
+    Vector prev(xRange.get(prevFrame->x), yRange.get(prevFrame->y));
+    Vector cur(xRange.get(curFrame->x), yRange.get(curFrame->y));
+    outValue = prev + (cur - prev) * percent;
+    return true;
+}
+
+void QuantizedVectorTimeline::clearIdentityFrames()
+{
+    auto& first = frames.front();
+    for (size_t i = 1; i < frames.size(); ++i)
+    {
+        if (frames[i].x != first.x || frames[i].y != first.y)
+        {
+            return;
+        }
+    }
+
+    frames.erase(frames.begin() + 1, frames.end());
+}
+
+int QuantizedVectorTimeline::getBoneIndex() const
+{
+    return boneIndex;
+}
+
+void QuantizedVectorTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.bones.set(boneIndex);
+}
+
+float QuantizedVectorTimeline::getLastFrameTime() const
+{
+    return frames.back().time / m_fps;
+}
+
+QuantizedTranslateTimeline::QuantizedTranslateTimeline(int framesCount, float fps)
+    : QuantizedVectorTimeline(framesCount, fps, Timeline::Type::QuantizedTranslate)
+{
+}
+
+void QuantizedTranslateTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    auto& bone = skeleton.bones[boneIndex];
+    applyToValue(bone.data, time, alpha, bone.translation, nullptr);
+}
+
+void QuantizedTranslateTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(pose.data.bones[boneIndex], time, alpha, pose.bones[boneIndex].translation, nullptr);
+}
+
+void QuantizedTranslateTimeline::applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const
+{
+    applyToValue(data, time, alpha, pose.translation, frameHint);
+}
+
+void QuantizedTranslateTimeline::applyToValue(const BoneData& data, float time, float alpha, Vector& inOutValue, size_t* frameHint) const
+{
+    Vector translation;
+    if (!getValue(time, translation, frameHint)) return;
+
+    inOutValue += (data.translation + translation - inOutValue) * alpha;
+}
+
+QuantizedScaleTimeline::QuantizedScaleTimeline(int framesCount, float fps)
+    : QuantizedVectorTimeline(framesCount, fps, Timeline::Type::QuantizedScale)
+{
+}
+
+void QuantizedScaleTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    auto& bone = skeleton.bones[boneIndex];
+    applyToValue(bone.data, time, alpha, bone.scale, nullptr);
+}
+
+void QuantizedScaleTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(pose.data.bones[boneIndex], time, alpha, pose.bones[boneIndex].scale, nullptr);
+}
+
+void QuantizedScaleTimeline::applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const
+{
+    applyToValue(data, time, alpha, pose.scale, frameHint);
+}
+
+void QuantizedScaleTimeline::applyToValue(const BoneData& data, float time, float alpha, Vector& inOutValue, size_t* frameHint) const
+{
+    Vector scale;
+    if (!getValue(time, scale, frameHint)) return;
+
+    inOutValue += (data.scale * scale - inOutValue) * alpha;
+}
+
+QuantizedShearTimeline::QuantizedShearTimeline(int framesCount, float fps)
+    : QuantizedVectorTimeline(framesCount, fps, Timeline::Type::QuantizedShear)
+{
+}
+
+void QuantizedShearTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    auto& bone = skeleton.bones[boneIndex];
+    applyToValue(bone.data, time, alpha, bone.shear, nullptr);
+}
+
+void QuantizedShearTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(pose.data.bones[boneIndex], time, alpha, pose.bones[boneIndex].shear, nullptr);
+}
+
+void QuantizedShearTimeline::applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const
+{
+    applyToValue(data, time, alpha, pose.shear, frameHint);
+}
+
+void QuantizedShearTimeline::applyToValue(const BoneData& data, float time, float alpha, Vector& inOutValue, size_t* frameHint) const
+{
+    Vector shear;
+    if (!getValue(time, shear, frameHint)) return;
+
+    inOutValue += (data.shear + shear - inOutValue) * alpha;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+QuantizedColorTimeline::QuantizedColorTimeline(int framesCount, float fps)
+    : QuantizedCurveTimeline(Timeline::Type::QuantizedColor, fps)
+{
+    frames.resize(framesCount);
+}
+
+void QuantizedColorTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    applyToValue(time, alpha, skeleton.slots[slotIndex].color);
+}
+
+void QuantizedColorTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(time, alpha, pose.slots[slotIndex].color);
+}
+
+void QuantizedColorTimeline::applyToValue(float time, float alpha, Color& inOutColor) const
+{
+    float frame = time * m_fps;
+
+    if (frame < frames.front().time) return; // time is before first frame
+
+    const float k = 1.f / 255;
+    Color color;
+
+    if (frame >= frames.back().time)
+    {
+        // time is after last frame
+        auto& last = frames.back();
+        color = Color(last.r * k, last.g * k, last.b * k, last.a * k);
+    }
+    else
+    {
+        // Interpolate between the previous frame and the current frame.
+        auto curFrame = findFrame(frames, frame);
+        auto prevFrame = curFrame - 1;
+
+        float percent = 1 - (frame - curFrame->time) / float(prevFrame->time - curFrame->time);
+        percent = getCurvePercent(prevFrame->curve, percent) * k;
+
+        color.r = prevFrame->r * k + (curFrame->r - prevFrame->r) * percent;
+        color.g = prevFrame->g * k + (curFrame->g - prevFrame->g) * percent;
+        color.b = prevFrame->b * k + (curFrame->b - prevFrame->b) * percent;
+        color.a = prevFrame->a * k + (curFrame->a - prevFrame->a) * percent;
+    }
+
+    if (alpha < 1)
+    {
+        inOutColor.r += (color.r - inOutColor.r) * alpha;
+        inOutColor.g += (color.g - inOutColor.g) * alpha;
+        inOutColor.b += (color.b - inOutColor.b) * alpha;
+        inOutColor.a += (color.a - inOutColor.a) * alpha;
+    }
+    else
+    {
+        inOutColor = color;
+    }
+}
+
+void QuantizedColorTimeline::clearIdentityFrames()
+{
+    auto& first = frames.front();
+    for (size_t i = 1; i < frames.size(); ++i)
+    {
+        auto& f = frames[i];
+        if (f.r != first.r || f.g != first.g || f.b != first.b || f.a != first.a)
+        {
+            return;
+        }
+    }
+
+    frames.erase(frames.begin() + 1, frames.end());
+}
+
+void QuantizedColorTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.slots.set(slotIndex);
+}
+
+float QuantizedColorTimeline::getLastFrameTime() const
+{
+    return frames.back().time / m_fps;
+}
+
+}
@@ -34,6 +34,7 @@
 #include <spinecpp/Bone.h>
 #include <spinecpp/Skeleton.h>
 #include <spinecpp/extension.h>
+#include <spinecpp/Trig.h>
 #include <cmath>
 
 namespace spine
@@ -79,7 +80,8 @@ void RegionAttachment::updateOffset()
     float localX2 = localX + regionWidth * regionScaleX;
     float localY2 = localY + regionHeight * regionScaleY;
     float radians = rotation * DEG_RAD;
-    float cosine = std::cos(radians), sine = std::sin(radians);
+    float sine, cosine;
+    trig::sincos(radians, sine, cosine);
     float localXCos = localX * cosine + translation.x;
     float localXSin = localX * sine;
     float localYCos = localY * cosine + translation.y;
@@ -98,10 +100,15 @@ void RegionAttachment::updateOffset()
     offset[3].y = localYCos + localX2Sin;
 }
 
-void RegionAttachment::computeWorldVertices(const Bone& bone, float* vertices) const
+namespace
+{
+
+// Transform is Bone or BoneWorldTransform
+template <typename Transform>
+void computeVertices(const Vector* offset, const Vector& translation, const Transform& bone, float* vertices)
 {
-    float x = bone.skeleton.translation.x + bone.worldPos.x;
-    float y = bone.skeleton.translation.y + bone.worldPos.y;
+    float x = translation.x + bone.worldPos.x;
+    float y = translation.y + bone.worldPos.y;
 
     vertices[0] = offset[0].x * bone.a + offset[0].y * bone.b + x;
     vertices[1] = offset[0].x * bone.c + offset[0].y * bone.d + y;
@@ -114,3 +121,19 @@ void RegionAttachment::computeWorldVertices(const Bone& bone, float* vertices) c
 }
 
 }
+
+void RegionAttachment::computeWorldVertices(const Bone& bone, float* vertices) const
+{
+    computeVertices(offset, bone.skeleton.translation, bone, vertices);
+}
+
+void RegionAttachment::computeWorldVertices(const Bone& bone, const BoneWorldTransform* transforms, float* vertices) const
+{
+    computeVertices(offset, bone.skeleton.translation, transforms[bone.data.index], vertices);
+}
+
+void RegionAttachment::computeWorldVertices(const Bone& bone, const Vector& translation, float* vertices) const
+{
+    computeVertices(offset, translation, bone, vertices);
+}
+}
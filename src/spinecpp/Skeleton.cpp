@@ -31,8 +31,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <spinecpp/Skeleton.h>
 #include <spinecpp/PathAttachment.h>
+#include <spinecpp/Trig.h>
+#include <spinecpp/extension.h>
 
 #include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
 
 namespace spine
 {
@@ -44,16 +49,9 @@ Skeleton::Skeleton(const SkeletonData& data)
     bones.reserve(data.bones.size());
     for (auto& bd : data.bones)
     {
-        Bone* parent = nullptr;
-        // find parent
-        for (auto& b : bones)
-        {
-            if (&b.data == bd.parent)
-            {
-                parent = &b;
-                break;
-            }
-        }
+        // parents come before their children in the data, so the parent is already created
+        assert(!bd.parent || bd.parent->index < bd.index);
+        Bone* parent = bd.parent ? &bones[bd.parent->index] : nullptr;
 
         bones.emplace_back(bd, *this, parent);
         
@@ -274,36 +272,1071 @@ void Skeleton::updateCache()
     {
         sortBone(bone);
     }
+
+    if (!m_requiredBones.empty())
+    {
+        removeUnrequiredUpdates();
+    }
+
+    m_updateOrder = m_updateCache;
+    m_lastBoneUpdates.assign(bones.size(), 0);
+    for (size_t i = 0; i < m_updateOrder.size(); ++i)
+    {
+        auto& c = m_updateOrder[i];
+        switch (c.type)
+        {
+        case UpdateCacheType::Bone:
+            m_lastBoneUpdates[reinterpret_cast<Bone*>(c.data)->data.index] = i;
+            break;
+        case UpdateCacheType::IkConstraint:
+            for (auto bone : reinterpret_cast<IkConstraint*>(c.data)->bones)
+            {
+                m_lastBoneUpdates[bone->data.index] = i;
+            }
+            break;
+        case UpdateCacheType::PathConstraint:
+            for (auto bone : reinterpret_cast<PathConstraint*>(c.data)->bones)
+            {
+                m_lastBoneUpdates[bone->data.index] = i;
+            }
+            break;
+        case UpdateCacheType::TransformConstraint:
+            for (auto bone : reinterpret_cast<TransformConstraint*>(c.data)->bones)
+            {
+                m_lastBoneUpdates[bone->data.index] = i;
+            }
+            break;
+        case UpdateCacheType::BoneRun:
+            assert(false);
+            break;
+        }
+    }
+    m_incrementalPoseValid = false;
+    m_updatedPoseValid = false;
+    m_updateLevels.clear();
+    m_previousTickTransforms.clear();
+    m_tickTransforms.clear();
+
+    if (m_transformStore)
+    {
+        addTransformStoreRuns();
+    }
+
+    compileUpdateSteps();
 }
 
-void Skeleton::updateWorldTransform()
+namespace
+{
+std::atomic<unsigned> requiredBonesVersion(0);
+}
+
+void Skeleton::setRequiredBones(const std::vector<int>& boneIndices)
+{
+    m_requiredBones = boneIndices;
+    if (m_requiredBones.empty())
+    {
+        m_requiredBonesMask.reset();
+    }
+
+    updateCache();
+}
+
+void Skeleton::removeUnrequiredUpdates()
 {
+    // Walk the update cache backwards and keep the elements which change a needed bone. The bones they use are needed
+    // by them, so they're needed from the elements before them.
+    std::vector<bool> needed(bones.size(), false);
+    for (auto i : m_requiredBones)
+    {
+        needed[i] = true;
+    }
+
+    if (!m_requiredBonesMask)
+    {
+        m_requiredBonesMask.reset(new AnimationMask(data));
+    }
+    auto& mask = *m_requiredBonesMask;
+    mask.setAllWeights(0);
+
+    std::vector<const Bone*> used, changed;
+    size_t end = m_updateCache.size();
+    for (size_t i = m_updateCache.size(); i-- > 0; )
+    {
+        used.clear();
+        changed.clear();
+        auto& c = m_updateCache[i];
+        getElemBones(c, used, changed);
+
+        bool keep = false;
+        for (auto bone : changed)
+        {
+            keep = keep || needed[bone->data.index];
+        }
+
+        if (!keep) continue;
+
+        for (auto bone : used)
+        {
+            needed[bone->data.index] = true;
+        }
+
+        if (c.type == UpdateCacheType::PathConstraint)
+        {
+            // the attachment and the deform of the target slot
+            mask.slotWeights[reinterpret_cast<PathConstraint*>(c.data)->target->data.index] = 1;
+        }
+
+        m_updateCache[--end] = c;
+    }
+    m_updateCache.erase(m_updateCache.begin(), m_updateCache.begin() + end);
+
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        if (needed[i]) mask.boneWeights[i] = 1;
+    }
+
+    m_requiredBonesVersion = ++requiredBonesVersion;
+}
+
+void Skeleton::compileUpdateSteps()
+{
+    m_updateSteps.clear();
+    m_updateItems.clear();
+    m_updateItems.reserve(m_updateCache.size());
+
     for (auto& c : m_updateCache)
     {
+        void (*update)(Skeleton&, const UpdateStep&) = nullptr;
+
         switch (c.type)
         {
         case UpdateCacheType::Bone:
-            reinterpret_cast<Bone*>(c.data)->updateWorldTransform();
+            switch (reinterpret_cast<Bone*>(c.data)->getInheritance())
+            {
+            case BoneInheritance::Root:
+                update = &updateBones<BoneInheritance::Root>;
+                break;
+            case BoneInheritance::Full:
+                update = &updateBones<BoneInheritance::Full>;
+                break;
+            case BoneInheritance::NoScale:
+                update = &updateBones<BoneInheritance::NoScale>;
+                break;
+            case BoneInheritance::NoRotation:
+                update = &updateBones<BoneInheritance::NoRotation>;
+                break;
+            case BoneInheritance::None:
+                update = &updateBones<BoneInheritance::None>;
+                break;
+            }
             break;
+        case UpdateCacheType::BoneRun:
+            m_updateSteps.push_back({ &updateTransformStoreRun, c.run, 1 });
+            continue;
         case UpdateCacheType::IkConstraint:
-            reinterpret_cast<IkConstraint*>(c.data)->apply();
+            update = &applyConstraints<IkConstraint>;
             break;
         case UpdateCacheType::PathConstraint:
-            reinterpret_cast<PathConstraint*>(c.data)->apply();
+            update = &applyConstraints<PathConstraint>;
             break;
         case UpdateCacheType::TransformConstraint:
-            reinterpret_cast<TransformConstraint*>(c.data)->apply();
+            update = &applyConstraints<TransformConstraint>;
             break;
         }
+
+        if (!m_updateSteps.empty() && m_updateSteps.back().update == update)
+        {
+            ++m_updateSteps.back().count;
+        }
+        else
+        {
+            m_updateSteps.push_back({ update, m_updateItems.size(), 1 });
+        }
+
+        m_updateItems.push_back(c.data);
+    }
+}
+
+template <BoneInheritance Inheritance>
+void Skeleton::updateBones(Skeleton& skeleton, const UpdateStep& step)
+{
+    auto bones = skeleton.m_updateItems.data() + step.begin;
+    for (size_t i = 0; i < step.count; ++i)
+    {
+        static_cast<Bone*>(bones[i])->updateWorldTransformAs<Inheritance>();
     }
 }
 
+template <typename Constraint>
+void Skeleton::applyConstraints(Skeleton& skeleton, const UpdateStep& step)
+{
+    auto constraints = skeleton.m_updateItems.data() + step.begin;
+    for (size_t i = 0; i < step.count; ++i)
+    {
+        static_cast<Constraint*>(constraints[i])->apply();
+    }
+}
+
+void Skeleton::updateTransformStoreRun(Skeleton& skeleton, const UpdateStep& step)
+{
+    skeleton.m_transformStore->updateRun(step.begin);
+}
+
+void Skeleton::addTransformStoreRuns()
+{
+    m_transformStore->clear();
+
+    std::vector<UpdateCacheElem> cache;
+    cache.reserve(m_updateCache.size());
+
+    std::vector<Bone*> run;
+    auto endRun = [&]()
+    {
+        if (run.size() > 1)
+        {
+            cache.emplace_back(m_transformStore->addRun(run));
+        }
+        else if (!run.empty())
+        {
+            cache.emplace_back(*run.front());
+        }
+
+        run.clear();
+    };
+
+    for (auto& c : m_updateCache)
+    {
+        if (c.type == UpdateCacheType::Bone)
+        {
+            run.push_back(reinterpret_cast<Bone*>(c.data));
+        }
+        else
+        {
+            endRun();
+            cache.push_back(c);
+        }
+    }
+
+    endRun();
+
+    m_updateCache.swap(cache);
+}
+
+void Skeleton::setTransformStoreEnabled(bool enabled)
+{
+    if (enabled == isTransformStoreEnabled()) return;
+
+    if (enabled)
+    {
+        m_transformStore.reset(new BoneTransformStore);
+    }
+    else
+    {
+        m_transformStore.reset();
+    }
+
+    updateCache();
+}
+
+void Skeleton::updateWorldTransform()
+{
+    for (auto& step : m_updateSteps)
+    {
+        step.update(*this, step);
+    }
+
+    m_incrementalPoseValid = false;
+    m_updatedPoseValid = false;
+}
+
+bool Skeleton::updateWorldTransformIncrementally()
+{
+    if (!m_incrementalPoseValid || m_incrementalFlipX != flipX || m_incrementalFlipY != flipY)
+    {
+        updateWorldTransform();
+
+        if (!m_incrementalPose)
+        {
+            m_incrementalPose.reset(new Pose(data));
+        }
+
+        m_incrementalPose->setFromSkeleton(*this);
+        m_incrementalTranslation = translation;
+        m_incrementalFlipX = flipX;
+        m_incrementalFlipY = flipY;
+        m_incrementalPoseValid = true;
+        return true;
+    }
+
+    // the world transforms may change without a call to updateWorldTransform
+    m_updatedPoseValid = false;
+
+    auto& pose = *m_incrementalPose;
+    bool changed = false;
+
+    m_changedBones.clear();
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        auto& b = pose.bones[i];
+        auto& bone = bones[i];
+        if (b.rotation != bone.rotation || b.translation != bone.translation || b.scale != bone.scale || b.shear != bone.shear)
+        {
+            m_changedBones.set(i);
+            b = bone.getPose();
+            changed = true;
+        }
+    }
+
+    if (m_incrementalTranslation != translation)
+    {
+        m_changedBones.set(0);
+        m_incrementalTranslation = translation;
+        changed = true;
+    }
+
+    m_changedConstraints.clear();
+    for (size_t i = 0; i < m_updateOrder.size(); ++i)
+    {
+        auto& c = m_updateOrder[i];
+        switch (c.type)
+        {
+        case UpdateCacheType::IkConstraint:
+        {
+            auto& ik = *reinterpret_cast<IkConstraint*>(c.data);
+            auto& p = pose.ikConstraints[&ik - ikConstraints.data()];
+            if (p.bendDirection != ik.bendDirection || p.mix != ik.mix)
+            {
+                p.bendDirection = ik.bendDirection;
+                p.mix = ik.mix;
+                m_changedConstraints.set(i);
+                changed = true;
+            }
+            break;
+        }
+        case UpdateCacheType::PathConstraint:
+        {
+            auto& pc = *reinterpret_cast<PathConstraint*>(c.data);
+            auto& p = pose.pathConstraints[&pc - pathConstraints.data()];
+            auto& slot = pose.slots[pc.target->data.index];
+            if (p.position != pc.position || p.spacing != pc.spacing || p.rotateMix != pc.rotateMix || p.translateMix != pc.translateMix
+                || slot.attachment != pc.target->getAttachment() || !pc.target->attachmentVertices.empty())
+            {
+                p.position = pc.position;
+                p.spacing = pc.spacing;
+                p.rotateMix = pc.rotateMix;
+                p.translateMix = pc.translateMix;
+                slot.attachment = pc.target->getAttachment();
+                m_changedConstraints.set(i);
+                changed = true;
+            }
+            break;
+        }
+        case UpdateCacheType::TransformConstraint:
+        {
+            auto& tc = *reinterpret_cast<TransformConstraint*>(c.data);
+            auto& p = pose.transformConstraints[&tc - transformConstraints.data()];
+            if (p.rotateMix != tc.rotateMix || p.translateMix != tc.translateMix || p.scaleMix != tc.scaleMix || p.shearMix != tc.shearMix)
+            {
+                p.rotateMix = tc.rotateMix;
+                p.translateMix = tc.translateMix;
+                p.scaleMix = tc.scaleMix;
+                p.shearMix = tc.shearMix;
+                m_changedConstraints.set(i);
+                changed = true;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    if (!changed) return false;
+
+    findDirtyUpdates();
+
+    m_dirtyUpdates.forEach([this](size_t i)
+    {
+        updateOrderElem(i);
+    });
+
+    return true;
+}
+
+void Skeleton::updateWorldTransform(const TaskExecutor& executor, size_t elementsPerTask)
+{
+    if (m_updateLevels.empty())
+    {
+        buildUpdateLevels();
+    }
+
+    const UpdateLevel* level = nullptr;
+    size_t numTasks = 0;
+    std::function<void(size_t)> task = [&](size_t t)
+    {
+        size_t size = level->end - level->begin;
+        size_t begin = level->begin + t * size / numTasks;
+        size_t end = level->begin + (t + 1) * size / numTasks;
+        for (size_t i = begin; i < end; ++i)
+        {
+            updateOrderElem(m_levelOrder[i]);
+        }
+    };
+
+    for (auto& l : m_updateLevels)
+    {
+        level = &l;
+        numTasks = (l.end - l.begin) / std::max(elementsPerTask, size_t(1));
+
+        if (numTasks > 1)
+        {
+            executor(numTasks, task);
+        }
+        else
+        {
+            numTasks = 1;
+            task(0);
+        }
+    }
+
+    m_incrementalPoseValid = false;
+    m_updatedPoseValid = false;
+}
+
+void Skeleton::storeTickWorldTransforms()
+{
+    m_previousTickTransforms.swap(m_tickTransforms);
+    m_tickTransforms.resize(bones.size());
+    for (size_t i = 0; i < bones.size(); ++i)
+    {
+        auto& bone = bones[i];
+        auto& transform = m_tickTransforms[i];
+        transform.a = bone.a;
+        transform.b = bone.b;
+        transform.c = bone.c;
+        transform.d = bone.d;
+        transform.worldPos = bone.worldPos;
+    }
+
+    if (m_previousTickTransforms.size() != m_tickTransforms.size())
+    {
+        m_previousTickTransforms = m_tickTransforms;
+    }
+}
+
+namespace
+{
+
+// wraps an angle difference from [-2 * PI, 2 * PI] to [-PI, PI]
+float shortestArc(float angle)
+{
+    if (angle > PI) return angle - PI_DBL;
+    if (angle < -PI) return angle + PI_DBL;
+    return angle;
+}
+
+void interpolateWorldTransform(const BoneWorldTransform& from, const BoneWorldTransform& to, float alpha, BoneWorldTransform& out)
+{
+    out.worldPos = from.worldPos + (to.worldPos - from.worldPos) * alpha;
+
+    if (from.a == to.a && from.b == to.b && from.c == to.c && from.d == to.d)
+    {
+        out.a = to.a;
+        out.b = to.b;
+        out.c = to.c;
+        out.d = to.d;
+        return;
+    }
+
+    // the x axis is (a, c) and the y axis is (b, d)
+    float fromRotationX = trig::atan2(from.c, from.a);
+    float fromRotationY = trig::atan2(from.d, from.b);
+    float rotationX = shortestArc(trig::atan2(to.c, to.a) - fromRotationX);
+    // the y axis takes the arc closest to the one of the x axis, so the angle between the axes changes the least
+    float rotationY = rotationX + shortestArc(shortestArc(trig::atan2(to.d, to.b) - fromRotationY) - rotationX);
+
+    float fromLengthX = std::sqrt(from.a * from.a + from.c * from.c);
+    float fromLengthY = std::sqrt(from.b * from.b + from.d * from.d);
+    float lengthX = fromLengthX + (std::sqrt(to.a * to.a + to.c * to.c) - fromLengthX) * alpha;
+    float lengthY = fromLengthY + (std::sqrt(to.b * to.b + to.d * to.d) - fromLengthY) * alpha;
+
+    float s, c;
+    trig::sincos(fromRotationX + rotationX * alpha, s, c);
+    out.a = c * lengthX;
+    out.c = s * lengthX;
+    trig::sincos(fromRotationY + rotationY * alpha, s, c);
+    out.b = c * lengthY;
+    out.d = s * lengthY;
+}
+
+}
+
+void Skeleton::interpolateWorldTransforms(float alpha, BoneWorldTransform* outTransforms) const
+{
+    assert(m_tickTransforms.size() == bones.size()); // storeTickWorldTransforms must be called first
+
+    if (alpha <= 0)
+    {
+        std::copy(m_previousTickTransforms.begin(), m_previousTickTransforms.end(), outTransforms);
+    }
+    else if (alpha >= 1)
+    {
+        std::copy(m_tickTransforms.begin(), m_tickTransforms.end(), outTransforms);
+    }
+    else
+    {
+        for (size_t i = 0; i < m_tickTransforms.size(); ++i)
+        {
+            interpolateWorldTransform(m_previousTickTransforms[i], m_tickTransforms[i], alpha, outTransforms[i]);
+        }
+    }
+}
+
+std::vector<int> Skeleton::getBoneUpdateOrder() const
+{
+    std::vector<int> order;
+    order.reserve(bones.size());
+    std::vector<bool> added(bones.size(), false);
+
+    std::function<void(const Bone&)> add = [&](const Bone& bone)
+    {
+        if (added[bone.data.index]) return;
+        if (bone.parent) add(*bone.parent);
+        added[bone.data.index] = true;
+        order.push_back(bone.data.index);
+    };
+
+    for (auto& c : m_updateOrder)
+    {
+        switch (c.type)
+        {
+        case UpdateCacheType::Bone:
+            add(*reinterpret_cast<Bone*>(c.data));
+            break;
+        case UpdateCacheType::IkConstraint:
+            for (auto bone : reinterpret_cast<IkConstraint*>(c.data)->bones) add(*bone);
+            break;
+        case UpdateCacheType::PathConstraint:
+            for (auto bone : reinterpret_cast<PathConstraint*>(c.data)->bones) add(*bone);
+            break;
+        case UpdateCacheType::TransformConstraint:
+            for (auto bone : reinterpret_cast<TransformConstraint*>(c.data)->bones) add(*bone);
+            break;
+        case UpdateCacheType::BoneRun:
+            assert(false);
+            break;
+        }
+    }
+
+    // bones which aren't updated at all
+    for (auto& bone : bones)
+    {
+        add(bone);
+    }
+
+    return order;
+}
+
+size_t Skeleton::getNumUpdateLevels()
+{
+    if (m_updateLevels.empty())
+    {
+        buildUpdateLevels();
+    }
+
+    return m_updateLevels.size();
+}
+
+void Skeleton::getElemBones(const UpdateCacheElem& c, std::vector<const Bone*>& used, std::vector<const Bone*>& changed) const
+{
+    // Bones which don't inherit rotation or scale use the applied transforms of all ancestors.
+    auto useParents = [&](const Bone& bone)
+    {
+        auto inheritance = bone.getInheritance();
+        if (inheritance == BoneInheritance::Root) return;
+        if (inheritance == BoneInheritance::Full)
+        {
+            used.push_back(bone.parent);
+            return;
+        }
+
+        for (auto p = bone.parent; p; p = p->parent)
+        {
+            used.push_back(p);
+        }
+    };
+
+    // the weighted path attachments of path constraints can come from any skin (like in updateCache)
+    auto usePathAttachment = [&](const Attachment* attachment)
+    {
+        if (!attachment || attachment->type != Attachment::Type::Path) return;
+
+        for (auto boneIndex : static_cast<const PathAttachment*>(attachment)->bones)
+        {
+            used.push_back(&bones[boneIndex]);
+        }
+    };
+
+    auto usePathAttachments = [&](const Skin& skin, int slotIndex)
+    {
+        for (auto& entry : skin.m_entries)
+        {
+            if (entry.slotIndex == slotIndex) usePathAttachment(entry.attachment);
+        }
+    };
+
+    switch (c.type)
+    {
+    case UpdateCacheType::Bone:
+    {
+        auto bone = reinterpret_cast<const Bone*>(c.data);
+        useParents(*bone);
+        changed.push_back(bone);
+        break;
+    }
+    case UpdateCacheType::IkConstraint:
+    {
+        auto& ik = *reinterpret_cast<const IkConstraint*>(c.data);
+        used.push_back(ik.target);
+        useParents(*ik.bones.front());
+        used.insert(used.end(), ik.bones.begin(), ik.bones.end());
+        changed.insert(changed.end(), ik.bones.begin(), ik.bones.end());
+        break;
+    }
+    case UpdateCacheType::PathConstraint:
+    {
+        auto& pc = *reinterpret_cast<const PathConstraint*>(c.data);
+        auto slot = pc.target;
+        used.push_back(&slot->bone);
+        if (m_skin) usePathAttachments(*m_skin, slot->data.index);
+        if (data.defaultSkin) usePathAttachments(*data.defaultSkin, slot->data.index);
+        for (auto& skin : data.skins)
+        {
+            usePathAttachments(skin, slot->data.index);
+        }
+        usePathAttachment(slot->getAttachment());
+        used.insert(used.end(), pc.bones.begin(), pc.bones.end());
+        changed.insert(changed.end(), pc.bones.begin(), pc.bones.end());
+        break;
+    }
+    case UpdateCacheType::TransformConstraint:
+    {
+        auto& tc = *reinterpret_cast<const TransformConstraint*>(c.data);
+        used.push_back(tc.target);
+        used.insert(used.end(), tc.bones.begin(), tc.bones.end());
+        changed.insert(changed.end(), tc.bones.begin(), tc.bones.end());
+        break;
+    }
+    case UpdateCacheType::BoneRun:
+        assert(false);
+        break;
+    }
+}
+
+void Skeleton::buildUpdateLevels()
+{
+    // The level of an element is after the levels of the last changes of the world transforms it uses, and for the
+    // world transforms it changes also after the levels of the elements which use them.
+    std::vector<int> changeLevels(bones.size(), -1), useLevels(bones.size(), -1);
+    std::vector<int> levels(m_updateOrder.size());
+    int numLevels = 0;
+
+    std::vector<const Bone*> used, changed;
+    for (size_t i = 0; i < m_updateOrder.size(); ++i)
+    {
+        used.clear();
+        changed.clear();
+        getElemBones(m_updateOrder[i], used, changed);
+
+        int level = 0;
+        for (auto bone : used)
+        {
+            level = std::max(level, changeLevels[bone->data.index] + 1);
+        }
+        for (auto bone : changed)
+        {
+            level = std::max(level, std::max(changeLevels[bone->data.index], useLevels[bone->data.index]) + 1);
+        }
+
+        for (auto bone : used)
+        {
+            auto& useLevel = useLevels[bone->data.index];
+            useLevel = std::max(useLevel, level);
+        }
+        for (auto bone : changed)
+        {
+            changeLevels[bone->data.index] = level;
+        }
+
+        levels[i] = level;
+        numLevels = std::max(numLevels, level + 1);
+    }
+
+    // sort the positions by level, keeping the update order within a level
+    m_updateLevels.assign(numLevels, UpdateLevel{ 0, 0 });
+    for (auto level : levels)
+    {
+        ++m_updateLevels[level].end;
+    }
+
+    size_t begin = 0;
+    for (auto& l : m_updateLevels)
+    {
+        size_t size = l.end;
+        l.begin = l.end = begin;
+        begin += size;
+    }
+
+    m_levelOrder.resize(m_updateOrder.size());
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        m_levelOrder[m_updateLevels[levels[i]].end++] = i;
+    }
+}
+
+void Skeleton::updateWorldTransforms(Skeleton* const* skeletons, size_t count)
+{
+    if (!count) return;
+
+    auto& first = *skeletons[0];
+
+    std::vector<Skeleton*> lockstep;
+    lockstep.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto skeleton = skeletons[i];
+        if (skeleton == &first || first.hasSameUpdateOrder(*skeleton))
+        {
+            lockstep.push_back(skeleton);
+            skeleton->m_incrementalPoseValid = false;
+            skeleton->m_updatedPoseValid = false;
+        }
+        else
+        {
+            skeleton->updateWorldTransform();
+        }
+    }
+
+    // The skeletons are updated in groups of one per SIMD lane, so the bones of a group stay in the cache for the
+    // whole walk of the update order
+    const size_t Lanes = 4;
+    for (size_t group = 0; group < lockstep.size(); group += Lanes)
+    {
+        auto groupSkeletons = lockstep.data() + group;
+        size_t groupSize = std::min(Lanes, lockstep.size() - group);
+
+        Bone* lanes[Lanes];
+        for (size_t i = 0; i < first.m_updateOrder.size(); ++i)
+        {
+            auto& c = first.m_updateOrder[i];
+            if (c.type == UpdateCacheType::Bone && reinterpret_cast<Bone*>(c.data)->getInheritance() == BoneInheritance::Full)
+            {
+                for (size_t s = 0; s < groupSize; ++s)
+                {
+                    lanes[s] = reinterpret_cast<Bone*>(groupSkeletons[s]->m_updateOrder[i].data);
+                }
+
+                BoneTransformStore::updateBones(lanes, groupSize);
+            }
+            else
+            {
+                for (size_t s = 0; s < groupSize; ++s)
+                {
+                    groupSkeletons[s]->updateOrderElem(i);
+                }
+            }
+        }
+    }
+}
+
+void Skeleton::updateWorldTransformWithoutConstraints()
+{
+    // parents come before their children
+    for (auto& bone : bones)
+    {
+        bone.updateWorldTransform();
+    }
+
+    m_incrementalPoseValid = false;
+    m_updatedPoseValid = false;
+}
+
+void Skeleton::updateOrderElem(size_t position)
+{
+    auto& c = m_updateOrder[position];
+    switch (c.type)
+    {
+    case UpdateCacheType::Bone:
+        reinterpret_cast<Bone*>(c.data)->updateWorldTransform();
+        break;
+    case UpdateCacheType::IkConstraint:
+        reinterpret_cast<IkConstraint*>(c.data)->apply();
+        break;
+    case UpdateCacheType::PathConstraint:
+        reinterpret_cast<PathConstraint*>(c.data)->apply();
+        break;
+    case UpdateCacheType::TransformConstraint:
+        reinterpret_cast<TransformConstraint*>(c.data)->apply();
+        break;
+    case UpdateCacheType::BoneRun:
+        assert(false);
+        break;
+    }
+}
+
+bool Skeleton::hasSameUpdateOrder(const Skeleton& other) const
+{
+    if (&other.data != &data || other.m_updateOrder.size() != m_updateOrder.size()) return false;
+
+    for (size_t i = 0; i < m_updateOrder.size(); ++i)
+    {
+        auto& c = m_updateOrder[i];
+        auto& o = other.m_updateOrder[i];
+        if (c.type != o.type) return false;
+
+        bool same = false;
+        switch (c.type)
+        {
+        case UpdateCacheType::Bone:
+            same = reinterpret_cast<Bone*>(c.data) - bones.data() == reinterpret_cast<Bone*>(o.data) - other.bones.data();
+            break;
+        case UpdateCacheType::IkConstraint:
+            same = reinterpret_cast<IkConstraint*>(c.data) - ikConstraints.data() == reinterpret_cast<IkConstraint*>(o.data) - other.ikConstraints.data();
+            break;
+        case UpdateCacheType::PathConstraint:
+            same = reinterpret_cast<PathConstraint*>(c.data) - pathConstraints.data() == reinterpret_cast<PathConstraint*>(o.data) - other.pathConstraints.data();
+            break;
+        case UpdateCacheType::TransformConstraint:
+            same = reinterpret_cast<TransformConstraint*>(c.data) - transformConstraints.data() == reinterpret_cast<TransformConstraint*>(o.data) - other.transformConstraints.data();
+            break;
+        case UpdateCacheType::BoneRun:
+            break;
+        }
+
+        if (!same) return false;
+    }
+
+    return true;
+}
+
+void Skeleton::findDirtyUpdates()
+{
+    // An element of the update cache must be updated if a bone it uses was recomputed before it, or if it's changed
+    // itself. Additionally an updated element must not use a stale value: a bone which wasn't recomputed has the value
+    // from the end of the last update, which is wrong if the bone is changed again after the element (like the parent
+    // of a bone constrained later). Such bones, and the bones constrained by an applied constraint (which changes
+    // their world transforms in place), are added to m_changedBones and the search is restarted. It terminates
+    // because m_changedBones only grows.
+    bool restart;
+
+    auto use = [&](const Bone& bone, size_t position)
+    {
+        auto i = bone.data.index;
+        if (!m_dirtyBones.test(i) && m_lastBoneUpdates[i] > position && !m_changedBones.test(i))
+        {
+            m_changedBones.set(i);
+            restart = true;
+        }
+    };
+
+    // bones which don't inherit rotation or scale use the applied transforms of all ancestors
+    auto useParents = [&](const Bone& bone, size_t position)
+    {
+        auto inheritance = bone.getInheritance();
+        if (inheritance == BoneInheritance::Root) return;
+        if (inheritance == BoneInheritance::Full)
+        {
+            use(*bone.parent, position);
+            return;
+        }
+
+        for (auto p = bone.parent; p; p = p->parent)
+        {
+            use(*p, position);
+        }
+    };
+
+    auto useFresh = [&](const Bone& bone)
+    {
+        auto i = bone.data.index;
+        if (!m_dirtyBones.test(i) && !m_changedBones.test(i))
+        {
+            m_changedBones.set(i);
+            restart = true;
+        }
+    };
+
+    auto isDirty = [this](const Bone& bone)
+    {
+        return m_dirtyBones.test(bone.data.index) || m_changedBones.test(bone.data.index);
+    };
+
+    do
+    {
+        restart = false;
+        m_dirtyBones.clear();
+        m_dirtyUpdates.clear();
+
+        for (size_t i = 0; i < m_updateOrder.size(); ++i)
+        {
+            auto& c = m_updateOrder[i];
+            bool update = m_changedConstraints.test(i);
+            switch (c.type)
+            {
+            case UpdateCacheType::Bone:
+            {
+                auto& bone = *reinterpret_cast<Bone*>(c.data);
+                update = m_changedBones.test(bone.data.index) || (bone.parent && m_dirtyBones.test(bone.parent->data.index));
+                if (!update) break;
+
+                useParents(bone, i);
+                m_dirtyBones.set(bone.data.index);
+                break;
+            }
+            case UpdateCacheType::IkConstraint:
+            {
+                auto& ik = *reinterpret_cast<IkConstraint*>(c.data);
+                update = update || isDirty(*ik.target) || isDirty(*ik.bones.front()->parent);
+                for (auto bone : ik.bones)
+                {
+                    update = update || isDirty(*bone);
+                }
+                if (!update) break;
+
+                use(*ik.target, i);
+                useParents(*ik.bones.front(), i);
+                if (ik.bones.size() > 1)
+                {
+                    // the parent bone is used in its world transform
+                    useFresh(*ik.bones.front());
+                }
+                for (auto bone : ik.bones)
+                {
+                    m_dirtyBones.set(bone->data.index);
+                }
+                break;
+            }
+            case UpdateCacheType::PathConstraint:
+            {
+                auto& pc = *reinterpret_cast<PathConstraint*>(c.data);
+                auto attachment = pc.target->getAttachment();
+                auto pathAttachment = attachment && attachment->type == Attachment::Type::Path ? static_cast<const PathAttachment*>(attachment) : nullptr;
+
+                update = update || isDirty(pc.target->bone);
+                if (pathAttachment)
+                {
+                    for (auto boneIndex : pathAttachment->bones)
+                    {
+                        update = update || isDirty(bones[boneIndex]);
+                    }
+                }
+                for (auto bone : pc.bones)
+                {
+                    update = update || isDirty(*bone);
+                }
+                if (!update) break;
+
+                use(pc.target->bone, i);
+                if (pathAttachment)
+                {
+                    for (auto boneIndex : pathAttachment->bones)
+                    {
+                        use(bones[boneIndex], i);
+                    }
+                }
+                for (auto bone : pc.bones)
+                {
+                    useFresh(*bone);
+                    m_dirtyBones.set(bone->data.index);
+                }
+                break;
+            }
+            case UpdateCacheType::TransformConstraint:
+            {
+                auto& tc = *reinterpret_cast<TransformConstraint*>(c.data);
+                update = update || isDirty(*tc.target);
+                for (auto bone : tc.bones)
+                {
+                    update = update || isDirty(*bone);
+                }
+                if (!update) break;
+
+                use(*tc.target, i);
+                for (auto bone : tc.bones)
+                {
+                    useFresh(*bone);
+                    m_dirtyBones.set(bone->data.index);
+                }
+                break;
+            }
+            case UpdateCacheType::BoneRun:
+                assert(false);
+                break;
+            }
+
+            if (update)
+            {
+                m_dirtyUpdates.set(i);
+            }
+        }
+    } while (restart);
+}
+
+bool Skeleton::updateWorldTransformIfChanged()
+{
+    if (m_updatedPoseValid && m_updatedPose->matches(*this)
+        && m_updatedTranslation == translation && m_updatedFlipX == flipX && m_updatedFlipY == flipY)
+    {
+        return false;
+    }
+
+    // invalidates m_updatedPose, so it's stored after
+    updateWorldTransform();
+
+    if (!m_updatedPose)
+    {
+        m_updatedPose.reset(new Pose(data));
+    }
+
+    m_updatedPose->setFromSkeleton(*this);
+    m_updatedTranslation = translation;
+    m_updatedFlipX = flipX;
+    m_updatedFlipY = flipY;
+    m_updatedPoseValid = true;
+    return true;
+}
+
 void Skeleton::setToSetupPose()
 {
     setBonesToSetupPose();
     setSlotsToSetupPose();
 }
 
+namespace
+{
+void setToSetupPose(IkConstraint& ik)
+{
+    ik.bendDirection = ik.data.bendDirection;
+    ik.mix = ik.data.mix;
+}
+
+void setToSetupPose(TransformConstraint& tc)
+{
+    tc.rotateMix = tc.data.rotateMix;
+    tc.translateMix = tc.data.translateMix;
+    tc.scaleMix = tc.data.scaleMix;
+    tc.shearMix = tc.data.shearMix;
+}
+
+void setToSetupPose(PathConstraint& pc)
+{
+    pc.position = pc.data.position;
+    pc.spacing = pc.data.spacing;
+    pc.rotateMix = pc.data.rotateMix;
+    pc.translateMix = pc.data.translateMix;
+}
+}
+
 void Skeleton::setBonesToSetupPose()
 {
     for (auto& b : bones)
@@ -313,24 +1346,17 @@ void Skeleton::setBonesToSetupPose()
 
     for (auto& ik : ikConstraints)
     {
-        ik.bendDirection = ik.data.bendDirection;
-        ik.mix = ik.data.mix;
+        spine::setToSetupPose(ik);
     }
 
     for (auto& tc : transformConstraints)
     {
-        tc.rotateMix = tc.data.rotateMix;
-        tc.translateMix = tc.data.translateMix;
-        tc.scaleMix = tc.data.scaleMix;
-        tc.shearMix = tc.data.shearMix;
+        spine::setToSetupPose(tc);
     }
 
     for (auto& pc : pathConstraints)
     {
-        pc.position = pc.data.position;
-        pc.spacing = pc.data.spacing;
-        pc.rotateMix = pc.data.rotateMix;
-        pc.translateMix = pc.data.translateMix;
+        spine::setToSetupPose(pc);
     }
 }
 
@@ -344,6 +1370,39 @@ void Skeleton::setSlotsToSetupPose()
     }
 }
 
+void Skeleton::setToSetupPose(const AnimationTargets& targets)
+{
+    targets.bones.forEach([this](size_t i)
+    {
+        bones[i].setToSetupPose();
+    });
+
+    targets.ikConstraints.forEach([this](size_t i)
+    {
+        spine::setToSetupPose(ikConstraints[i]);
+    });
+
+    targets.transformConstraints.forEach([this](size_t i)
+    {
+        spine::setToSetupPose(transformConstraints[i]);
+    });
+
+    targets.pathConstraints.forEach([this](size_t i)
+    {
+        spine::setToSetupPose(pathConstraints[i]);
+    });
+
+    targets.slots.forEach([this](size_t i)
+    {
+        slots[i].setToSetupPose();
+    });
+
+    if (targets.drawOrder)
+    {
+        resetDrawOrder();
+    }
+}
+
 void Skeleton::resetDrawOrder()
 {
     drawOrder.clear();
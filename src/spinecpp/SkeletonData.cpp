@@ -131,4 +131,14 @@ int SkeletonData::findPathConstraintIndex(const char* constraintName) const
     return findIndexByName(pathConstraints, constraintName);
 }
 
+void SkeletonData::compressAnimations(size_t residentBudget)
+{
+    animationCache.setBudget(residentBudget);
+
+    for (auto& animation : animations)
+    {
+        animationCache.add(animation);
+    }
+}
+
 }
@@ -32,6 +32,7 @@
 #include <spinecpp/SkeletonJson.h>
 #include <spinecpp/extension.h>
 #include <spinecpp/SkeletonData.h>
+#include <spinecpp/Skeleton.h>
 #include <spinecpp/Atlas.h>
 #include <spinecpp/AtlasAttachmentLoader.h>
 #include <spinecpp/RegionAttachment.h>
@@ -43,6 +44,7 @@
 #include "sajson/sajson.h"
 
 #include <memory>
+#include <cassert>
 
 using namespace std;
 
@@ -111,7 +113,6 @@ static Color Color_fromHexString(const string& c)
 
 SkeletonData* SkeletonJson::readSkeletonData(const std::string& json)
 {
-    using sajson::literal;
     const sajson::document& doc = sajson::parse(sajson::string(json.c_str(), json.length()));
 
     if (!doc.is_valid())
@@ -122,9 +123,32 @@ SkeletonData* SkeletonJson::readSkeletonData(const std::string& json)
 
     m_error.clear();
 
+    const auto& root = doc.get_root();
+
+    if (m_reorderBones)
+    {
+        // Read the bones, slots and constraints in the exported order to find the order in which the bones are
+        // updated, then read the skeleton data with the bones in that order. The attachments are only loaded by the
+        // second read.
+        std::unique_ptr<SkeletonData> exported(readSkeleton(root, true));
+        if (!exported) return nullptr;
+
+        Skeleton skeleton(*exported);
+        m_boneOrder = skeleton.getBoneUpdateOrder();
+    }
+
+    auto skeletonData = readSkeleton(root, false);
+    m_boneOrder.clear();
+    m_boneIndices.clear();
+    return skeletonData;
+}
+
+SkeletonData* SkeletonJson::readSkeleton(const sajson::value& root, bool bonesAndConstraintsOnly)
+{
+    using sajson::literal;
+
     std::unique_ptr<SkeletonData> skeletonData(new SkeletonData);
 
-    const auto& root = doc.get_root();
     const auto len = root.get_length();
 
     /* Skeleton. */
@@ -146,9 +170,21 @@ SkeletonData* SkeletonJson::readSkeletonData(const std::string& json)
         const auto numBones = jbones.get_length();
         skeletonData->bones.reserve(numBones);
 
+        // the index of each bone by its exported index
+        m_boneIndices.clear();
+        if (!m_boneOrder.empty())
+        {
+            assert(m_boneOrder.size() == numBones);
+            m_boneIndices.resize(numBones);
+            for (size_t i = 0; i < numBones; ++i)
+            {
+                m_boneIndices[m_boneOrder[i]] = int(i);
+            }
+        }
+
         for (size_t i = 0; i < numBones; ++i)
         {
-            const auto& jbone = jbones.get_array_element(i);
+            const auto& jbone = jbones.get_array_element(m_boneOrder.empty() ? i : m_boneOrder[i]);
             const char* parentName = jbone.get_safe_string_value_of_key(literal("parent"));
 
             const BoneData* parent = nullptr;
@@ -408,6 +444,11 @@ SkeletonData* SkeletonJson::readSkeletonData(const std::string& json)
         }
     }
 
+    if (bonesAndConstraintsOnly)
+    {
+        return skeletonData.release();
+    }
+
     /* Skins. */
     const auto iskins = root.find_object_key(literal("skins"));
     if (iskins < len)
@@ -656,6 +697,8 @@ SkeletonData* SkeletonJson::readSkeletonData(const std::string& json)
 
     }
 
+    skeletonData->boneIndicesByExportedIndex = m_boneIndices;
+
     /* Animations. */
     const auto ianims = root.find_object_key(literal("animations"));
     if (ianims < len)
@@ -1296,6 +1339,8 @@ void SkeletonJson::readAnimation(Animation& anim, const SkeletonData& skeletonDa
         anim.timelines.emplace_back(timeline);
         anim.duration = std::max(anim.duration, timeline->frames.back().time);
     }
+
+    anim.updateTargets();
 }
 
 void SkeletonJson::readCurve(CurveFrame& frame, const sajson::value& json)
@@ -1373,7 +1418,8 @@ void SkeletonJson::readVertices(const sajson::value& json, VertexAttachment& att
             attachment.bones[b++] = bc;
             for (int ib = 0; ib < bc; ++ib)
             {
-                attachment.bones[b++] = jvertices.get_array_element(v).get_integer_value();
+                int boneIndex = jvertices.get_array_element(v).get_integer_value();
+                attachment.bones[b++] = m_boneIndices.empty() ? boneIndex : m_boneIndices[boneIndex];
                 attachment.vertices[w++] = jvertices.get_array_element(v + 1).get_safe_float_value() * m_scale;
                 attachment.vertices[w++] = jvertices.get_array_element(v + 2).get_safe_float_value() * m_scale;
                 attachment.vertices[w++] = jvertices.get_array_element(v + 3).get_safe_float_value();
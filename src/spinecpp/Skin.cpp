@@ -92,6 +92,25 @@ const char* Skin::getAttachmentName(int slotIndex, int attachmentIndex) const
     return nullptr;
 }
 
+int Skin::getEntryIndex(const Attachment* attachment) const
+{
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        if (m_entries[i].attachment == attachment)
+        {
+            return int(i);
+        }
+    }
+
+    return -1;
+}
+
+const Attachment* Skin::getEntryAttachment(int entryIndex) const
+{
+    if (entryIndex < 0 || size_t(entryIndex) >= m_entries.size()) return nullptr;
+    return m_entries[entryIndex].attachment;
+}
+
 void Skin::attachAll(Skeleton& skeleton, const Skin& oldSkin) const
 {
     for (auto& e : oldSkin.m_entries)
@@ -37,9 +37,11 @@
 #include <spinecpp/Event.h>
 #include <spinecpp/Attachment.h>
 #include <spinecpp/MeshAttachment.h>
+#include <spinecpp/Pose.h>
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 
 namespace spine
 {
@@ -55,6 +57,28 @@ typename std::vector<Frame>::const_iterator findFrame(const std::vector<Frame>&
     });
 }
 
+// Same as findFrame, but the search starts at the hint (if not null), which is updated with the found frame.
+// Searches for increasing times with the same hint only step over the frames in between.
+template <typename Frame>
+typename std::vector<Frame>::const_iterator findFrame(const std::vector<Frame>& frames, float time, size_t* hint)
+{
+    if (!hint || *hint == 0 || *hint > frames.size() || time < frames[*hint - 1].time)
+    {
+        auto frame = findFrame(frames, time);
+        if (hint) *hint = frame - frames.begin();
+        return frame;
+    }
+
+    size_t i = *hint;
+    while (i < frames.size() && !(time < frames[i].time))
+    {
+        ++i;
+    }
+
+    *hint = i;
+    return frames.begin() + i;
+}
+
 
 inline void normalizeAngle(float& angle)
 {
@@ -129,6 +153,11 @@ float CurveFrame::getCurvePercent(float percent) const
     if (type == CurveFrame::Type::Linear) return percent;
     if (type == CurveFrame::Type::Stepped) return 0;
 
+    return getBezierCurvePercent(bezierData, percent);
+}
+
+float CurveFrame::getBezierCurvePercent(const Vector* bezierData, float percent)
+{
     Vector prev(0, 0);
     for (int i = 0; i < BEZIER_DATA_SIZE; ++i)
     {
@@ -176,20 +205,39 @@ RotateTimeline::RotateTimeline(int framesCount)
 
 void RotateTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
 {
-    if (time < frames.front().time) return; // time is before first frame
-
     auto& bone = skeleton.bones[boneIndex];
+    applyToValue(bone.data, time, alpha, bone.rotation, nullptr);
+}
+
+void RotateTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(pose.data.bones[boneIndex], time, alpha, pose.bones[boneIndex].rotation, nullptr);
+}
+
+int RotateTimeline::getBoneIndex() const
+{
+    return boneIndex;
+}
+
+void RotateTimeline::applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const
+{
+    applyToValue(data, time, alpha, pose.rotation, frameHint);
+}
+
+void RotateTimeline::applyToValue(const BoneData& data, float time, float alpha, float& inOutRotation, size_t* frameHint) const
+{
+    if (time < frames.front().time) return; // time is before first frame
 
     if (time >= frames.back().time) // time is after last frame
     {
-        float amount = bone.data.rotation + frames.back().angle - bone.rotation;
+        float amount = data.rotation + frames.back().angle - inOutRotation;
         normalizeAngle(amount);
-        bone.rotation += amount * alpha;
+        inOutRotation += amount * alpha;
         return;
     }
 
     // Interpolate between the previous frame and the current frame.
-    auto curFrame = findFrame(frames, time);
+    auto curFrame = findFrame(frames, time, frameHint);
     auto prevFrame = curFrame - 1;
 
     float percent = 1 - (time - curFrame->time) / (prevFrame->time - curFrame->time);
@@ -197,9 +245,9 @@ void RotateTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::
 
     float amount = curFrame->angle - prevFrame->angle;
     normalizeAngle(amount);
-    amount = bone.data.rotation + (prevFrame->angle + amount * percent) - bone.rotation;
+    amount = data.rotation + (prevFrame->angle + amount * percent) - inOutRotation;
     normalizeAngle(amount);
-    bone.rotation += amount * alpha;
+    inOutRotation += amount * alpha;
 }
 
 void RotateTimeline::clearIdentityFrames()
@@ -216,6 +264,16 @@ void RotateTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void RotateTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.bones.set(boneIndex);
+}
+
+float RotateTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 TranslateTimeline::TranslateTimeline(int framesCount)
@@ -227,28 +285,47 @@ TranslateTimeline::TranslateTimeline(int framesCount)
 
 void TranslateTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
 {
-    if (time < frames.front().time) return; // time is before first frame
-
     auto& bone = skeleton.bones[boneIndex];
+    applyToValue(bone.data, time, alpha, bone.translation, nullptr);
+}
+
+void TranslateTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(pose.data.bones[boneIndex], time, alpha, pose.bones[boneIndex].translation, nullptr);
+}
+
+int TranslateTimeline::getBoneIndex() const
+{
+    return boneIndex;
+}
+
+void TranslateTimeline::applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const
+{
+    applyToValue(data, time, alpha, pose.translation, frameHint);
+}
+
+void TranslateTimeline::applyToValue(const BoneData& data, float time, float alpha, Vector& inOutTranslation, size_t* frameHint) const
+{
+    if (time < frames.front().time) return; // time is before first frame
 
     if (time >= frames.back().time) // time is after last frame
     {
-        bone.translation += (bone.data.translation + frames.back().translation - bone.translation) * alpha;
+        inOutTranslation += (data.translation + frames.back().translation - inOutTranslation) * alpha;
         return;
     }
 
     // Interpolate between the previous frame and the current frame.
-    auto curFrame = findFrame(frames, time);
+    auto curFrame = findFrame(frames, time, frameHint);
     auto prevFrame = curFrame - 1;
 
     float percent = 1 - (time - curFrame->time) / (prevFrame->time - curFrame->time);
     percent = prevFrame->getCurvePercent(percent);
 
-    bone.translation +=
+    inOutTranslation +=
         (
-        bone.data.translation
+        data.translation
         + prevFrame->translation + (curFrame->translation - prevFrame->translation) * percent
-        - bone.translation
+        - inOutTranslation
         ) * alpha;
 }
 
@@ -266,6 +343,16 @@ void TranslateTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void TranslateTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.bones.set(boneIndex);
+}
+
+float TranslateTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -278,28 +365,47 @@ ScaleTimeline::ScaleTimeline(int framesCount)
 
 void ScaleTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
 {
-    if (time < frames.front().time) return; // time is before first frame
-
     auto& bone = skeleton.bones[boneIndex];
+    applyToValue(bone.data, time, alpha, bone.scale, nullptr);
+}
+
+void ScaleTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(pose.data.bones[boneIndex], time, alpha, pose.bones[boneIndex].scale, nullptr);
+}
+
+int ScaleTimeline::getBoneIndex() const
+{
+    return boneIndex;
+}
+
+void ScaleTimeline::applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const
+{
+    applyToValue(data, time, alpha, pose.scale, frameHint);
+}
+
+void ScaleTimeline::applyToValue(const BoneData& data, float time, float alpha, Vector& inOutScale, size_t* frameHint) const
+{
+    if (time < frames.front().time) return; // time is before first frame
 
     if (time >= frames.back().time) // time is after last frame
     {
-        bone.scale += (bone.data.scale * frames.back().scale - bone.scale) * alpha;
+        inOutScale += (data.scale * frames.back().scale - inOutScale) * alpha;
         return;
     }
 
     // Interpolate between the previous frame and the current frame.
-    auto curFrame = findFrame(frames, time);
+    auto curFrame = findFrame(frames, time, frameHint);
     auto prevFrame = curFrame - 1;
 
     float percent = 1 - (time - curFrame->time) / (prevFrame->time - curFrame->time);
     percent = prevFrame->getCurvePercent(percent);
 
-    bone.scale +=
+    inOutScale +=
         (
-        bone.data.scale
+        data.scale
         * (prevFrame->scale + (curFrame->scale - prevFrame->scale) * percent)
-        - bone.scale
+        - inOutScale
         ) * alpha;
 }
 
@@ -317,6 +423,16 @@ void ScaleTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void ScaleTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.bones.set(boneIndex);
+}
+
+float ScaleTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ShearTimeline::ShearTimeline(int framesCount)
@@ -328,27 +444,46 @@ ShearTimeline::ShearTimeline(int framesCount)
 
 void ShearTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
 {
-    if (time < frames.front().time) return; // time is before first frame
-
     auto& bone = skeleton.bones[boneIndex];
+    applyToValue(bone.data, time, alpha, bone.shear, nullptr);
+}
+
+void ShearTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(pose.data.bones[boneIndex], time, alpha, pose.bones[boneIndex].shear, nullptr);
+}
+
+int ShearTimeline::getBoneIndex() const
+{
+    return boneIndex;
+}
+
+void ShearTimeline::applyToBonePose(BonePose& pose, const BoneData& data, float time, float alpha, size_t* frameHint) const
+{
+    applyToValue(data, time, alpha, pose.shear, frameHint);
+}
+
+void ShearTimeline::applyToValue(const BoneData& data, float time, float alpha, Vector& inOutShear, size_t* frameHint) const
+{
+    if (time < frames.front().time) return; // time is before first frame
 
     if (time >= frames.back().time) // time is after last frame
     {
-        bone.shear += (bone.data.shear + frames.back().shear - bone.shear) * alpha;
+        inOutShear += (data.shear + frames.back().shear - inOutShear) * alpha;
         return;
     }
 
     // Interpolate between the previous frame and the current frame.
-    auto curFrame = findFrame(frames, time);
+    auto curFrame = findFrame(frames, time, frameHint);
     auto prevFrame = curFrame - 1;
 
     float percent = 1 - (time - curFrame->time) / (prevFrame->time - curFrame->time);
     percent = prevFrame->getCurvePercent(percent);
 
-    bone.shear += 
-        (bone.data.shear 
+    inOutShear += 
+        (data.shear 
         + (prevFrame->shear + (curFrame->shear - prevFrame->shear) * percent)
-        - bone.shear
+        - inOutShear
         ) * alpha;
 }
 
@@ -366,6 +501,16 @@ void ShearTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void ShearTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.bones.set(boneIndex);
+}
+
+float ShearTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ColorTimeline::ColorTimeline(int framesCount)
@@ -376,6 +521,16 @@ ColorTimeline::ColorTimeline(int framesCount)
 }
 
 void ColorTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    applyToValue(time, alpha, skeleton.slots[slotIndex].color);
+}
+
+void ColorTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(time, alpha, pose.slots[slotIndex].color);
+}
+
+void ColorTimeline::applyToValue(float time, float alpha, Color& inOutColor) const
 {
     if (time < frames.front().time) return; // time is before first frame
 
@@ -401,18 +556,16 @@ void ColorTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::v
         color.a = prevFrame->color.a + (curFrame->color.a - prevFrame->color.a) * percent;
     }
 
-    auto& slot = skeleton.slots[slotIndex];
-
     if (alpha < 1)
     {
-        slot.color.r += (color.r - slot.color.r) * alpha;
-        slot.color.g += (color.g - slot.color.g) * alpha;
-        slot.color.b += (color.b - slot.color.b) * alpha;
-        slot.color.a += (color.a - slot.color.a) * alpha;
+        inOutColor.r += (color.r - inOutColor.r) * alpha;
+        inOutColor.g += (color.g - inOutColor.g) * alpha;
+        inOutColor.b += (color.b - inOutColor.b) * alpha;
+        inOutColor.a += (color.a - inOutColor.a) * alpha;
     }
     else
     {
-        slot.color = color;
+        inOutColor = color;
     }
 }
 
@@ -430,6 +583,16 @@ void ColorTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void ColorTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.slots.set(slotIndex);
+}
+
+float ColorTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -439,27 +602,45 @@ AttachmentTimeline::AttachmentTimeline()
 
 void AttachmentTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
 {
-    if (time < frames.front().time) return; // time is before first frame
+    auto frame = getFrame(time);
+    if (!frame) return;
 
-    std::vector<Frame>::const_iterator prevFrame;
-    if (time >= frames.back().time) // time is after last frame
+    const Attachment* attachment = nullptr;
+
+    if (!frame->attachmentName.empty())
     {
-        prevFrame = frames.end() - 1;
+        attachment = skeleton.getAttachmentForSlotIndex(slotIndex, frame->attachmentName);
     }
-    else
+
+    auto& slot = skeleton.slots[slotIndex];
+    slot.setAttachment(attachment);
+}
+
+void AttachmentTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    auto frame = getFrame(time);
+    if (!frame) return;
+
+    const Attachment* attachment = nullptr;
+
+    if (!frame->attachmentName.empty())
     {
-        prevFrame = findFrame(frames, time) - 1;
+        attachment = pose.getAttachmentForSlotIndex(slotIndex, frame->attachmentName);
     }
 
-    const Attachment* attachment = nullptr;
+    pose.slots[slotIndex].attachment = attachment;
+}
+
+const AttachmentTimeline::Frame* AttachmentTimeline::getFrame(float time) const
+{
+    if (time < frames.front().time) return nullptr; // time is before first frame
 
-    if (!prevFrame->attachmentName.empty())
+    if (time >= frames.back().time) // time is after last frame
     {
-        attachment = skeleton.getAttachmentForSlotIndex(slotIndex, prevFrame->attachmentName);
+        return &frames.back();
     }
 
-    auto& slot = skeleton.slots[slotIndex];
-    slot.setAttachment(attachment);
+    return &*(findFrame(frames, time) - 1);
 }
 
 void AttachmentTimeline::clearIdentityFrames()
@@ -476,6 +657,16 @@ void AttachmentTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void AttachmentTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.slots.set(slotIndex);
+}
+
+float AttachmentTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 EventTimeline::EventTimeline()
@@ -528,12 +719,27 @@ void EventTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::v
     }
 }
 
+void EventTimeline::applyToPose(Pose&, float, float) const
+{
+    // events don't change the pose
+}
+
 void EventTimeline::clearIdentityFrames()
 {
     // this is never identity
     return;
 }
 
+void EventTimeline::addTargets(AnimationTargets&) const
+{
+    // events don't change the skeleton
+}
+
+float EventTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -567,26 +773,44 @@ void DrawOrderTimeline::setFrame(int frameIndex, float time, const std::vector<i
 
 void DrawOrderTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
 {
-    if (time < frames.front().time) return; // time is before first frame
+    auto frame = getFrame(time);
+    if (!frame) return;
 
-    std::vector<Frame>::const_iterator frame;
-    if (time >= frames.back().time) // time is after last frame
+    if (frame->drawOrder)
     {
-        frame = frames.end() - 1;
+        skeleton.setDrawOrder(frame->drawOrder);
     }
     else
     {
-        frame = findFrame(frames, time) - 1;
+        skeleton.resetDrawOrder();
     }
+}
+
+void DrawOrderTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    auto frame = getFrame(time);
+    if (!frame) return;
 
     if (frame->drawOrder)
     {
-        skeleton.setDrawOrder(frame->drawOrder);
+        pose.drawOrder.assign(frame->drawOrder, frame->drawOrder + m_slotsCount);
     }
     else
     {
-        skeleton.resetDrawOrder();
+        pose.resetDrawOrder();
+    }
+}
+
+const DrawOrderTimeline::Frame* DrawOrderTimeline::getFrame(float time) const
+{
+    if (time < frames.front().time) return nullptr; // time is before first frame
+
+    if (time >= frames.back().time) // time is after last frame
+    {
+        return &frames.back();
     }
+
+    return &*(findFrame(frames, time) - 1);
 }
 
 void DrawOrderTimeline::clearIdentityFrames()
@@ -609,6 +833,16 @@ void DrawOrderTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void DrawOrderTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.drawOrder = true;
+}
+
+float DrawOrderTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -731,6 +965,11 @@ void DeformTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::
     }
 }
 
+void DeformTimeline::applyToPose(Pose&, float, float) const
+{
+    // poses don't contain attachment vertices
+}
+
 void DeformTimeline::clearIdentityFrames()
 {
     auto verts = frames.front().vertices;
@@ -751,6 +990,16 @@ void DeformTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void DeformTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.slots.set(slotIndex);
+}
+
+float DeformTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 IkConstraintTimeline::IkConstraintTimeline(int framesCount)
@@ -760,12 +1009,11 @@ IkConstraintTimeline::IkConstraintTimeline(int framesCount)
     initFramesBezeierData(frames, m_bezierDataBuffer);
 }
 
-void IkConstraintTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+template <typename Constraint>
+void IkConstraintTimeline::applyToConstraint(float time, float alpha, Constraint& constraint) const
 {
     if (time < frames.front().time) return; // time is before first frame
 
-    auto& constraint = skeleton.ikConstraints[ikConstraintIndex];
-
     if (time >= frames.back().time) // time is after last frame
     {
         constraint.mix += (frames.back().mix - constraint.mix) * alpha;
@@ -785,6 +1033,16 @@ void IkConstraintTimeline::apply(Skeleton& skeleton, float lastTime, float time,
     constraint.bendDirection = prevFrame->bendDirection;
 }
 
+void IkConstraintTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    applyToConstraint(time, alpha, skeleton.ikConstraints[ikConstraintIndex]);
+}
+
+void IkConstraintTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToConstraint(time, alpha, pose.ikConstraints[ikConstraintIndex]);
+}
+
 void IkConstraintTimeline::clearIdentityFrames()
 {
     auto mix = frames.front().mix;
@@ -800,6 +1058,16 @@ void IkConstraintTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void IkConstraintTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.ikConstraints.set(ikConstraintIndex);
+}
+
+float IkConstraintTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 TransformConstraintTimeline::TransformConstraintTimeline(int framesCount)
@@ -809,12 +1077,11 @@ TransformConstraintTimeline::TransformConstraintTimeline(int framesCount)
     initFramesBezeierData(frames, m_bezierDataBuffer);
 }
 
-void TransformConstraintTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+template <typename Constraint>
+void TransformConstraintTimeline::applyToConstraint(float time, float alpha, Constraint& constraint) const
 {
     if (time < frames.front().time) return; // time is before first frame
 
-    auto& constraint = skeleton.transformConstraints[transformConstraintIndex];
-
     if (time >= frames.back().time) // time is after last frame
     {
         constraint.rotateMix += (frames.back().rotateMix - constraint.rotateMix) * alpha;
@@ -842,6 +1109,16 @@ void TransformConstraintTimeline::apply(Skeleton& skeleton, float lastTime, floa
     constraint.shearMix += (shear + (curFrame->shearMix - shear) * percent - constraint.shearMix) * alpha;
 }
 
+void TransformConstraintTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    applyToConstraint(time, alpha, skeleton.transformConstraints[transformConstraintIndex]);
+}
+
+void TransformConstraintTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToConstraint(time, alpha, pose.transformConstraints[transformConstraintIndex]);
+}
+
 void TransformConstraintTimeline::clearIdentityFrames()
 {
     float rotateMix = frames.front().rotateMix;
@@ -875,6 +1152,16 @@ void TransformConstraintTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void TransformConstraintTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.transformConstraints.set(transformConstraintIndex);
+}
+
+float TransformConstraintTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 PathConstraintTimeline::PathConstraintTimeline(int framesCount, Timeline::Type type)
@@ -898,6 +1185,16 @@ void PathConstraintTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void PathConstraintTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.pathConstraints.set(pathConstraintIndex);
+}
+
+float PathConstraintTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 void PathConstraintTimeline::applyToValue(float time, float alpha, float& inOutValue) const
 {
     if (time < frames.front().time) return; // time is before first frame
@@ -932,6 +1229,11 @@ void PathConstraintPositionTimeline::apply(Skeleton& skeleton, float lastTime, f
     applyToValue(time, alpha, constraint.position);
 }
 
+void PathConstraintPositionTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(time, alpha, pose.pathConstraints[pathConstraintIndex].position);
+}
+
 PathConstraintSpacingTimeline::PathConstraintSpacingTimeline(int framesCount)
     : PathConstraintTimeline(framesCount, Timeline::Type::PathConstraintSpacing)
 {
@@ -943,6 +1245,11 @@ void PathConstraintSpacingTimeline::apply(Skeleton& skeleton, float lastTime, fl
     applyToValue(time, alpha, constraint.spacing);
 }
 
+void PathConstraintSpacingTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToValue(time, alpha, pose.pathConstraints[pathConstraintIndex].spacing);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 PathConstraintMixTimeline::PathConstraintMixTimeline(int framesCount)
@@ -952,12 +1259,11 @@ PathConstraintMixTimeline::PathConstraintMixTimeline(int framesCount)
     initFramesBezeierData(frames, m_bezierDataBuffer);
 }
 
-void PathConstraintMixTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+template <typename Constraint>
+void PathConstraintMixTimeline::applyToConstraint(float time, float alpha, Constraint& constraint) const
 {
     if (time < frames.front().time) return; // time is before first frame
 
-    auto& constraint = skeleton.pathConstraints[pathConstraintIndex];
-
     if (time >= frames.back().time) // time is after last frame
     {
         constraint.rotateMix += (frames.back().rotateMix - constraint.rotateMix) * alpha;
@@ -978,6 +1284,16 @@ void PathConstraintMixTimeline::apply(Skeleton& skeleton, float lastTime, float
     constraint.translateMix += (translateMix + (curFrame->translateMix - translateMix) * percent - constraint.translateMix) * alpha;
 }
 
+void PathConstraintMixTimeline::apply(Skeleton& skeleton, float lastTime, float time, std::vector<const Event*>* firedEvents, float alpha) const
+{
+    applyToConstraint(time, alpha, skeleton.pathConstraints[pathConstraintIndex]);
+}
+
+void PathConstraintMixTimeline::applyToPose(Pose& pose, float time, float alpha) const
+{
+    applyToConstraint(time, alpha, pose.pathConstraints[pathConstraintIndex]);
+}
+
 void PathConstraintMixTimeline::clearIdentityFrames()
 {
     auto rotateMix = frames.front().rotateMix;
@@ -998,5 +1314,15 @@ void PathConstraintMixTimeline::clearIdentityFrames()
     frames.erase(frames.begin() + 1, frames.end());
 }
 
+void PathConstraintMixTimeline::addTargets(AnimationTargets& targets) const
+{
+    targets.pathConstraints.set(pathConstraintIndex);
+}
+
+float PathConstraintMixTimeline::getLastFrameTime() const
+{
+    return frames.back().time;
+}
+
 
 }
@@ -32,6 +32,7 @@
 #include <spinecpp/TransformConstraint.h>
 #include <spinecpp/Skeleton.h>
 #include <spinecpp/extension.h>
+#include <spinecpp/Trig.h>
 
 #include <cmath>
 using namespace std;
@@ -65,13 +66,13 @@ void TransformConstraint::apply()
         if (rotateMix > 0)
         {
             float a = bone->a, b = bone->b, c = bone->c, d = bone->d;
-            float r = atan2(tc, ta) - atan2(c, a) + data.offsetRotation * DEG_RAD;
+            float r = trig::atan2(tc, ta) - trig::atan2(c, a) + data.offsetRotation * DEG_RAD;
 
             if (r > PI) r -= PI_DBL;
             else if (r < -PI) r += PI_DBL;
             r *= rotateMix;
-            float cosine = cos(r);
-            float sine = sin(r);
+            float sine, cosine;
+            trig::sincos(r, sine, cosine);
             bone->a = cosine * a - sine * c;
             bone->b = cosine * b - sine * d;
             bone->c = sine * a + cosine * c;
@@ -104,15 +105,17 @@ void TransformConstraint::apply()
         if (shearMix > 0)
         {
             float b = bone->b, d = bone->d;
-            float by = atan2(d, b);
-            float r = atan2(td, tb) - atan2(tc, ta) - (by - atan2(bone->c, bone->a));
+            float by = trig::atan2(d, b);
+            float r = trig::atan2(td, tb) - trig::atan2(tc, ta) - (by - trig::atan2(bone->c, bone->a));
             float s = sqrt(b * b + d * d);
 
             if (r > PI) r -= PI_DBL;
             else if (r < -PI) r += PI_DBL;
             r = by + (r + data.offsetShearY * DEG_RAD) * shearMix;
-            bone->b = cos(r) * s;
-            bone->d = sin(r) * s;
+            float sine, cosine;
+            trig::sincos(r, sine, cosine);
+            bone->b = cosine * s;
+            bone->d = sine * s;
         }
     }
 }
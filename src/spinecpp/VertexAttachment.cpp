@@ -50,20 +50,25 @@ void VertexAttachment::computeWorldVertices(const Slot& slot, float* outWorldVer
     computeWorldVertices(0, worldVerticesCount * 2, slot, outWorldVertices, 0);
 }
 
-void VertexAttachment::computeWorldVertices(int start, int count, const Slot& slot, float* outWorldVertices, int offset) const
+namespace
+{
+
+// Transform is Bone or BoneWorldTransform, transforms are by bone index
+template <typename Transform>
+void computeVertices(const VertexAttachment& attachment, int start, int count, const Slot& slot, const Transform* transforms, const Vector& translation, float* outWorldVertices, int offset)
 {
+    auto& bones = attachment.bones;
     count += offset;
-    auto& skeleton = slot.bone.skeleton;
-    auto x = skeleton.translation.x;
-    auto y = skeleton.translation.y;
+    auto x = translation.x;
+    auto y = translation.y;
     auto deformLength = slot.attachmentVertices.size() * 2;
-    auto fvertices = vertices.data();
+    auto fvertices = attachment.vertices.data();
     auto deform = reinterpret_cast<const float*>(slot.attachmentVertices.data());
     
     if (bones.empty())
     {
         if (deformLength > 0) fvertices = deform;
-        auto& bone = slot.bone;
+        auto& bone = transforms[slot.bone.data.index];
         x += bone.worldPos.x;
         y += bone.worldPos.y;
         for (int v = start, w = offset; w < count; v += 2, w += 2) {
@@ -82,7 +87,6 @@ void VertexAttachment::computeWorldVertices(int start, int count, const Slot& sl
             skip += n;
         }
 
-        auto& skeletonBones = skeleton.bones;
         if (deformLength == 0)
         {
             for (int w = offset, b = skip * 3; w < count; w += 2) {
@@ -91,7 +95,7 @@ void VertexAttachment::computeWorldVertices(int start, int count, const Slot& sl
                 n += v;
                 for (; v < n; v++, b += 3)
                 {
-                    auto& bone = skeletonBones[bones[v]];
+                    auto& bone = transforms[bones[v]];
                     float vx = fvertices[b], vy = fvertices[b + 1], weight = fvertices[b + 2];
                     wx += (vx * bone.a + vy * bone.b + bone.worldPos.x) * weight;
                     wy += (vx * bone.c + vy * bone.d + bone.worldPos.y) * weight;
@@ -108,7 +112,7 @@ void VertexAttachment::computeWorldVertices(int start, int count, const Slot& sl
                 n += v;
                 for (; v < n; v++, b += 3, f += 2)
                 {
-                    auto& bone = skeletonBones[bones[v]];
+                    auto& bone = transforms[bones[v]];
                     float vx = fvertices[b] + deform[f], vy = fvertices[b + 1] + deform[f + 1], weight = fvertices[b + 2];
                     wx += (vx * bone.a + vy * bone.b + bone.worldPos.x) * weight;
                     wy += (vx * bone.c + vy * bone.d + bone.worldPos.y) * weight;
@@ -121,3 +125,30 @@ void VertexAttachment::computeWorldVertices(int start, int count, const Slot& sl
 }
 
 }
+
+void VertexAttachment::computeWorldVertices(int start, int count, const Slot& slot, float* outWorldVertices, int offset) const
+{
+    computeVertices(*this, start, count, slot, slot.bone.skeleton.bones.data(), slot.bone.skeleton.translation, outWorldVertices, offset);
+}
+
+void VertexAttachment::computeWorldVertices(const Slot& slot, const BoneWorldTransform* transforms, float* outWorldVertices) const
+{
+    computeWorldVertices(0, worldVerticesCount * 2, slot, transforms, outWorldVertices, 0);
+}
+
+void VertexAttachment::computeWorldVertices(int start, int count, const Slot& slot, const BoneWorldTransform* transforms, float* outWorldVertices, int offset) const
+{
+    computeVertices(*this, start, count, slot, transforms, slot.bone.skeleton.translation, outWorldVertices, offset);
+}
+
+void VertexAttachment::computeWorldVertices(const Slot& slot, const Vector& translation, float* outWorldVertices) const
+{
+    computeWorldVertices(0, worldVerticesCount * 2, slot, translation, outWorldVertices, 0);
+}
+
+void VertexAttachment::computeWorldVertices(int start, int count, const Slot& slot, const Vector& translation, float* outWorldVertices, int offset) const
+{
+    computeVertices(*this, start, count, slot, slot.bone.skeleton.bones.data(), translation, outWorldVertices, offset);
+}
+
+}
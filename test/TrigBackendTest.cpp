@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+// Poses a rig with the Std and the Fast trig backends and checks that the world transforms stay within the documented
+// differences (see Trig.h).
+#include <spinecpp/spinecpp.h>
+#include <spinecpp/PathAttachment.h>
+#include <spinecpp/extension.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spine
+{
+void AtlasPage_createTexture(Atlas::Page&, const char*) {}
+void AtlasPage_disposeTexture(Atlas::Page&) {}
+std::string Util_readFile(const std::string&) { return std::string(); }
+}
+
+using namespace spine;
+
+namespace
+{
+
+class PathLoader : public AttachmentLoader
+{
+protected:
+    Attachment* createAttachmentImpl(const Skin&, Attachment::Type type, const std::string& name, const std::string&) override
+    {
+        if (type == Attachment::Type::Path) return new PathAttachment(name);
+        return nullptr;
+    }
+};
+
+// bones with every kind of inheritance, and an IK, a transform and a path constraint
+const char* rigJson = R"({
+"skeleton": { "hash": "trig", "spine": "3.4.02", "width": 0, "height": 0 },
+"bones": [
+    { "name": "root" },
+    { "name": "hip", "parent": "root", "y": 40, "rotation": 90, "scaleX": 1.2, "shearX": 5 },
+    { "name": "torso", "parent": "hip", "length": 30, "x": 5, "rotation": -20, "scaleY": 0.8 },
+    { "name": "head", "parent": "torso", "length": 10, "x": 30, "inheritRotation": false },
+    { "name": "arm", "parent": "torso", "length": 20, "x": 25, "rotation": 120, "inheritScale": false },
+    { "name": "hand", "parent": "arm", "length": 8, "x": 20, "shearY": 10 },
+    { "name": "thigh", "parent": "hip", "length": 20, "rotation": 170 },
+    { "name": "shin", "parent": "thigh", "length": 20, "x": 20, "rotation": -30 },
+    { "name": "target", "parent": "root", "x": 15, "y": 5 },
+    { "name": "tail", "parent": "hip", "length": 15, "rotation": -150, "scaleX": -1 },
+    { "name": "p1", "parent": "root", "length": 20 },
+    { "name": "p2", "parent": "p1", "length": 20, "x": 20 },
+    { "name": "p3", "parent": "p2", "length": 20, "x": 20 }
+],
+"slots": [ { "name": "path", "bone": "root", "attachment": "path" } ],
+"ik": [ { "name": "leg", "bones": [ "thigh", "shin" ], "target": "target", "bendPositive": false } ],
+"transform": [ { "name": "tail", "bones": [ "tail" ], "target": "hand", "rotation": 30, "x": 3,
+    "rotateMix": 0.7, "translateMix": 0.5, "scaleMix": 0.3, "shearMix": 0.2 } ],
+"path": [ { "name": "path", "bones": [ "p1", "p2", "p3" ], "target": "path", "rotateMode": "chain",
+    "positionMode": "fixed", "position": 5, "spacing": 30, "rotation": 13, "rotateMix": 0.8, "translateMix": 0.7 } ],
+"skins": { "default": { "path": { "path": { "type": "path", "constantSpeed": true, "vertexCount": 9,
+    "lengths": [ 60, 120, 200 ],
+    "vertices": [ -10, 0, 0, 0, 10, 30, 40, 40, 70, 10, 90, -20, 110, 30, 130, 40, 150, 60 ] } } } },
+"animations": { "move": {
+    "bones": {
+        "hip": { "rotate": [ { "time": 0, "angle": 0 }, { "time": 1, "angle": 350 } ] },
+        "arm": { "rotate": [ { "time": 0, "angle": -170 }, { "time": 1, "angle": 170 } ] },
+        "target": { "translate": [ { "time": 0, "x": 0, "y": 0 }, { "time": 1, "x": -30, "y": 20 } ] },
+        "p2": { "rotate": [ { "time": 0, "angle": 0 }, { "time": 1, "angle": 90 } ] }
+    }
+} }
+})";
+
+// the maximum differences documented in Trig.h
+const float maxMatrixDifference = 1e-5f; // of a, b, c and d
+const float maxPositionDifference = 1e-5f; // of the world positions, relative to their distance from the origin (at least 1)
+
+struct Difference
+{
+    float matrix = 0;
+    float position = 0;
+};
+
+std::vector<BoneWorldTransform> pose(const SkeletonData& data, float time)
+{
+    Skeleton skeleton(data);
+    data.findAnimation("move")->apply(skeleton, -1, time, false, nullptr);
+    skeleton.updateWorldTransform();
+
+    std::vector<BoneWorldTransform> transforms;
+    for (auto& bone : skeleton.bones)
+    {
+        BoneWorldTransform t = { bone.a, bone.b, bone.c, bone.d, bone.worldPos };
+        transforms.push_back(t);
+    }
+    return transforms;
+}
+
+}
+
+int main()
+{
+    PathLoader loader;
+    SkeletonJson json(loader);
+    std::unique_ptr<SkeletonData> data(json.readSkeletonData(rigJson));
+    if (!data)
+    {
+        printf("failed to load the rig: %s\n", json.getError().c_str());
+        return 1;
+    }
+
+    Difference max;
+    for (int i = 0; i <= 100; ++i)
+    {
+        float time = i / 100.f;
+
+        setTrigBackend(TrigBackend::Std);
+        auto std = pose(*data, time);
+        setTrigBackend(TrigBackend::Fast);
+        auto fast = pose(*data, time);
+
+        for (size_t b = 0; b < std.size(); ++b)
+        {
+            auto& s = std[b];
+            auto& f = fast[b];
+            max.matrix = std::max({ max.matrix, std::abs(s.a - f.a), std::abs(s.b - f.b), std::abs(s.c - f.c), std::abs(s.d - f.d) });
+            float distance = std::max(1.f, std::sqrt(s.worldPos.x * s.worldPos.x + s.worldPos.y * s.worldPos.y));
+            max.position = std::max(max.position, std::max(std::abs(s.worldPos.x - f.worldPos.x), std::abs(s.worldPos.y - f.worldPos.y)) / distance);
+        }
+    }
+
+    setTrigBackend(TrigBackend::Std);
+
+    printf("max difference: matrix %g, position %g\n", max.matrix, max.position);
+    if (max.matrix > maxMatrixDifference || max.position > maxPositionDifference)
+    {
+        printf("FAILED: the differences are above the documented maximum of %g\n", maxMatrixDifference);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
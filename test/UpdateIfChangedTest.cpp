@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// Spine Runtimes Software License
+// Version 2.4
+//
+// Copyright (c) 2013-2016, Esoteric Software
+// Copyright (c) 2016, Chobolabs
+// All rights reserved.
+//
+// You are granted a perpetual, non-exclusive, non-sublicensable and
+// non-transferable license to use, install, execute and perform the Spine
+// Runtimes Software (the "Software") and derivative works solely for personal
+// or internal use. Without the written permission of Esoteric Software (see
+// Section 2 of the Spine Software License Agreement), you may not (a) modify,
+// translate, adapt or otherwise create derivative works, improvements of
+// the Software or develop new applications using the Software or (b) remove,
+// delete, alter or obscure any trademarks or any copyright, trademark, patent
+// or other intellectual property or proprietary rights notices on or in the
+// Software, including any copy thereof. Redistributions in binary or source
+// form must include this license and terms.
+//
+// THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE AND CHOBOLABS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE OR CHOBOLABS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+// Checks that Skeleton::updateWorldTransformIfChanged doesn't skip an update after the world transforms were changed by
+// another update, even if the pose is the same as at its last call.
+#include <spinecpp/spinecpp.h>
+#include <spinecpp/extension.h>
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spine
+{
+void AtlasPage_createTexture(Atlas::Page&, const char*) {}
+void AtlasPage_disposeTexture(Atlas::Page&) {}
+std::string Util_readFile(const std::string&) { return std::string(); }
+}
+
+using namespace spine;
+
+namespace
+{
+
+class NullLoader : public AttachmentLoader
+{
+protected:
+    Attachment* createAttachmentImpl(const Skin&, Attachment::Type, const std::string&, const std::string&) override
+    {
+        return nullptr;
+    }
+};
+
+const char* rigJson = R"({
+"skeleton": { "hash": "ifchanged", "spine": "3.4.02", "width": 0, "height": 0 },
+"bones": [
+    { "name": "root" },
+    { "name": "upper", "parent": "root", "length": 20, "rotation": 30 },
+    { "name": "lower", "parent": "upper", "length": 20, "x": 20, "rotation": -40 },
+    { "name": "other", "parent": "root", "length": 10, "x": 5, "rotation": 80 }
+]
+})";
+
+// poses P and Q of the test
+void poseP(Skeleton& skeleton)
+{
+    skeleton.setToSetupPose();
+}
+
+void poseQ(Skeleton& skeleton)
+{
+    skeleton.setToSetupPose();
+    skeleton.bones[1].rotation = 75;
+    skeleton.bones[3].rotation = -20;
+}
+
+// true if the world transforms of the skeleton are the ones of a full update of its pose
+bool isUpToDate(const Skeleton& skeleton)
+{
+    Skeleton reference(skeleton.data);
+    for (size_t i = 0; i < skeleton.bones.size(); ++i)
+    {
+        reference.bones[i].setPose(skeleton.bones[i].getPose());
+    }
+    reference.updateWorldTransform();
+
+    for (size_t i = 0; i < skeleton.bones.size(); ++i)
+    {
+        auto& a = skeleton.bones[i];
+        auto& b = reference.bones[i];
+        if (a.a != b.a || a.b != b.b || a.c != b.c || a.d != b.d || a.worldPos != b.worldPos) return false;
+    }
+    return true;
+}
+
+// Updates at P with updateWorldTransformIfChanged, changes the world transforms at Q with the given update, then checks
+// that updateWorldTransformIfChanged at P updates again.
+bool check(const char* name, const SkeletonData& data, const std::function<void(Skeleton&)>& update)
+{
+    Skeleton skeleton(data);
+    poseP(skeleton);
+    skeleton.updateWorldTransformIfChanged();
+
+    poseQ(skeleton);
+    update(skeleton);
+
+    poseP(skeleton);
+    bool updated = skeleton.updateWorldTransformIfChanged();
+    bool upToDate = isUpToDate(skeleton);
+
+    printf("%s: %s\n", name, updated && upToDate ? "OK" : "FAILED");
+    return updated && upToDate;
+}
+
+}
+
+int main()
+{
+    NullLoader loader;
+    SkeletonJson json(loader);
+    std::unique_ptr<SkeletonData> data(json.readSkeletonData(rigJson));
+    if (!data)
+    {
+        printf("failed to load the rig: %s\n", json.getError().c_str());
+        return 1;
+    }
+
+    bool ok = true;
+
+    ok &= check("updateWorldTransform", *data, [](Skeleton& s) { s.updateWorldTransform(); });
+
+    ok &= check("updateWorldTransform with executor", *data, [](Skeleton& s)
+    {
+        TaskExecutor executor = [](size_t count, const std::function<void(size_t)>& task)
+        {
+            for (size_t i = 0; i < count; ++i) task(i);
+        };
+        s.updateWorldTransform(executor, 1);
+    });
+
+    ok &= check("updateWorldTransforms", *data, [](Skeleton& s)
+    {
+        Skeleton* skeletons[] = { &s };
+        Skeleton::updateWorldTransforms(skeletons, 1);
+    });
+
+    ok &= check("updateWorldTransformIncrementally", *data, [](Skeleton& s)
+    {
+        // the first call is a full update, the second one an incremental one
+        s.updateWorldTransformIncrementally();
+        s.bones[2].rotation = 10;
+        s.updateWorldTransformIncrementally();
+    });
+
+    ok &= check("updateWorldTransformWithoutConstraints", *data, [](Skeleton& s) { s.updateWorldTransformWithoutConstraints(); });
+
+    // a restricted update at P leaves the bones outside the required ones stale, so the full update at P must be done
+    {
+        Skeleton skeleton(*data);
+        poseQ(skeleton);
+        skeleton.updateWorldTransform();
+
+        poseP(skeleton);
+        skeleton.setRequiredBones({ 2 });
+        skeleton.updateWorldTransformIfChanged();
+        skeleton.setRequiredBones({});
+        bool updated = skeleton.updateWorldTransformIfChanged();
+        bool upToDate = isUpToDate(skeleton);
+
+        printf("setRequiredBones: %s\n", updated && upToDate ? "OK" : "FAILED");
+        ok &= updated && upToDate;
+    }
+
+    return ok ? 0 : 1;
+}